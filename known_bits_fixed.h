@@ -0,0 +1,383 @@
+// Fixed-width KnownBits: the Zero/One masks of an abstract value of at most 64
+// bits held in machine words, the base-3 decoding of abstract values, and the
+// fixed-width versions of the transfer functions. Shared by the fixed-width
+// backends of main.cpp and the CUDA kernels of sweep_gpu.cu, so nothing here
+// depends on LLVM, and every function the kernels call is VERIFY_HOST_DEVICE.
+
+#ifndef KNOWN_BITS_FIXED_H
+#define KNOWN_BITS_FIXED_H
+
+#include <cassert>
+#include <cstdint>
+
+// Marks the functions compiled for both the host and the device by nvcc
+#ifdef __CUDACC__
+#define VERIFY_HOST_DEVICE __host__ __device__
+#else
+#define VERIFY_HOST_DEVICE
+#endif
+
+// Abstract values are decoded a block of TritBlockDigits base-3 digits at a time,
+// through a table of the Zero/One patterns of every block value
+static const unsigned TritBlockDigits = 5;
+static const unsigned TritBlockSize = 243; // 3^TritBlockDigits
+
+struct TritBlockTable {
+    uint64_t Zero[TritBlockSize];
+    uint64_t One[TritBlockSize];
+
+    constexpr TritBlockTable() : Zero(), One() {
+        for (unsigned Block = 0; Block < TritBlockSize; ++Block) {
+            unsigned Digits = Block;
+            for (unsigned Bit = 0; Bit < TritBlockDigits; ++Bit, Digits /= 3) {
+                Zero[Block] |= uint64_t(Digits % 3 == 0) << Bit;
+                One[Block] |= uint64_t(Digits % 3 == 1) << Bit;
+            }
+        }
+    }
+};
+
+static constexpr TritBlockTable TritBlocks;
+
+// Mask of the low Bits bits of a word. Unlike maskTrailingOnes it can be used
+// in constant expressions and on the device.
+VERIFY_HOST_DEVICE constexpr uint64_t lowBitsMask(unsigned Bits) {
+    return Bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+}
+
+// Function to decode the base-3 index of an abstract value of BitWidth <= 64 bits
+// into Zero/One masks held in machine words. Each bit can be 0 (known zero), 1
+// (known one), or X (unknown), and bit i of the abstract value is digit i of its
+// index written in base 3. Digits are looked up TritBlockDigits at a time in the
+// BlockZero/BlockOne columns of a TritBlockTable, and the digits above the last
+// nonzero one are all known zero. The device passes its copy of the table.
+VERIFY_HOST_DEVICE constexpr void decodeKnownBitsMasks(const uint64_t *BlockZero, const uint64_t *BlockOne,
+                                                       uint64_t Index, unsigned BitWidth, uint64_t &Zero,
+                                                       uint64_t &One) {
+    Zero = One = 0;
+    unsigned Bit = 0;
+    for (; Index != 0 && Bit < BitWidth; Bit += TritBlockDigits) {
+        unsigned Block = Index % TritBlockSize;
+        Index /= TritBlockSize;
+        Zero |= BlockZero[Block] << Bit;
+        One |= BlockOne[Block] << Bit;
+    }
+    uint64_t Mask = lowBitsMask(BitWidth);
+    Zero = (Zero | ~lowBitsMask(Bit)) & Mask;
+    One &= Mask;
+}
+
+// Function to decode the base-3 index of an abstract value through TritBlocks
+constexpr void decodeKnownBitsMasks(uint64_t Index, unsigned BitWidth, uint64_t &Zero, uint64_t &One) {
+    decodeKnownBitsMasks(TritBlocks.Zero, TritBlocks.One, Index, BitWidth, Zero, One);
+}
+
+// Precision relationship of a first abstract value with respect to a second one
+enum class PrecisionOrder { Equal, FirstMorePrecise, SecondMorePrecise, Incomparable };
+
+// KnownBits of a compile-time bitwidth N <= 64 with Zero/One held in machine words.
+// Bits at and above N are always clear in both masks.
+template <unsigned N>
+struct KnownBitsFixed {
+    static_assert(0 < N && N <= 64, "Unsupported fixed bitwidth");
+
+    uint64_t Zero = 0;
+    uint64_t One = 0;
+
+    VERIFY_HOST_DEVICE static constexpr uint64_t mask() { return N == 64 ? ~uint64_t(0) : (uint64_t(1) << N) - 1; }
+
+    VERIFY_HOST_DEVICE constexpr bool operator==(const KnownBitsFixed &Other) const {
+        return Zero == Other.Zero && One == Other.One;
+    }
+    VERIFY_HOST_DEVICE constexpr bool operator!=(const KnownBitsFixed &Other) const { return !(*this == Other); }
+};
+
+// Arithmetic shift right of an N-bit value held in the low bits of a word
+template <unsigned N>
+VERIFY_HOST_DEVICE constexpr uint64_t ashrFixed(uint64_t Value, unsigned ShiftAmt) {
+    int64_t SignAtTop = int64_t(Value << (64 - N));
+    return uint64_t(SignAtTop >> (64 - N + ShiftAmt)) & KnownBitsFixed<N>::mask();
+}
+
+// Fixed-width version of sextInRegComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE constexpr KnownBitsFixed<N> sextInRegCompositeFixed(const KnownBitsFixed<N> &KBInstance,
+                                                                       unsigned SrcBitWidth) {
+    assert(0 < SrcBitWidth && SrcBitWidth <= N && "Illegal sext-in-register");
+
+    if (SrcBitWidth == N)
+        return KBInstance;
+
+    unsigned ExtBits = N - SrcBitWidth;
+    KnownBitsFixed<N> Result;
+    Result.One = ashrFixed<N>((KBInstance.One << ExtBits) & KnownBitsFixed<N>::mask(), ExtBits);
+    Result.Zero = ashrFixed<N>((KBInstance.Zero << ExtBits) & KnownBitsFixed<N>::mask(), ExtBits);
+    return Result;
+}
+
+// Fixed-width version of sextInRegDecomposed, copying and extending whole masks
+// instead of single bits
+template <unsigned N>
+VERIFY_HOST_DEVICE constexpr KnownBitsFixed<N> sextInRegDecomposedFixed(const KnownBitsFixed<N> &KBInstance,
+                                                                        unsigned SrcBitWidth) {
+    assert(0 < SrcBitWidth && SrcBitWidth <= N && "Illegal sext-in-register");
+
+    if (SrcBitWidth == N)
+        return KBInstance;
+
+    uint64_t LowBits = lowBitsMask(SrcBitWidth);
+    uint64_t ExtendedBits = KnownBitsFixed<N>::mask() & ~LowBits;
+    KnownBitsFixed<N> Result;
+
+    // Copy the original known bits into the lower SrcBitWidth bits
+    Result.One = KBInstance.One & LowBits;
+    Result.Zero = KBInstance.Zero & LowBits;
+
+    // Extend the sign bit into the higher bits, which stay unknown if it is unknown.
+    // The extension is selected with masks so that batches of calls vectorize.
+    unsigned SignBitIndex = SrcBitWidth - 1;
+    Result.One |= ExtendedBits & (0 - ((KBInstance.One >> SignBitIndex) & 1));
+    Result.Zero |= ExtendedBits & (0 - ((KBInstance.Zero >> SignBitIndex) & 1));
+
+    return Result;
+}
+
+// Fixed-width version of zextInRegComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> zextInRegCompositeFixed(const KnownBitsFixed<N> &KBInstance,
+                                                             unsigned SrcBitWidth) {
+    assert(0 < SrcBitWidth && SrcBitWidth <= N && "Illegal zext-in-register");
+    uint64_t LowBits = lowBitsMask(SrcBitWidth);
+    KnownBitsFixed<N> Result;
+    Result.One = KBInstance.One & LowBits;
+    Result.Zero = (KBInstance.Zero & LowBits) | (KnownBitsFixed<N>::mask() & ~LowBits);
+    return Result;
+}
+
+// Fixed-width version of zextInRegDecomposed
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> zextInRegDecomposedFixed(const KnownBitsFixed<N> &KBInstance,
+                                                              unsigned SrcBitWidth) {
+    assert(0 < SrcBitWidth && SrcBitWidth <= N && "Illegal zext-in-register");
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t Bit = uint64_t(1) << i;
+        if (i >= SrcBitWidth)
+            Result.Zero |= Bit;
+        else {
+            Result.One |= KBInstance.One & Bit;
+            Result.Zero |= KBInstance.Zero & Bit;
+        }
+    }
+    return Result;
+}
+
+// Fixed-width version of shlComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> shlCompositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    KnownBitsFixed<N> Result;
+    Result.One = (KBInstance.One << ShiftAmt) & KnownBitsFixed<N>::mask();
+    Result.Zero = ((KBInstance.Zero << ShiftAmt) | lowBitsMask(ShiftAmt)) & KnownBitsFixed<N>::mask();
+    return Result;
+}
+
+// Fixed-width version of shlDecomposed
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> shlDecomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        if (i < ShiftAmt) {
+            Result.Zero |= uint64_t(1) << i;
+            continue;
+        }
+        Result.One |= ((KBInstance.One >> (i - ShiftAmt)) & 1) << i;
+        Result.Zero |= ((KBInstance.Zero >> (i - ShiftAmt)) & 1) << i;
+    }
+    return Result;
+}
+
+// Fixed-width version of lshrComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> lshrCompositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    const uint64_t Mask = KnownBitsFixed<N>::mask();
+    KnownBitsFixed<N> Result;
+    Result.One = KBInstance.One >> ShiftAmt;
+    Result.Zero = (KBInstance.Zero >> ShiftAmt) | (Mask & ~(Mask >> ShiftAmt));
+    return Result;
+}
+
+// Fixed-width version of lshrDecomposed
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> lshrDecomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        if (i + ShiftAmt >= N) {
+            Result.Zero |= uint64_t(1) << i;
+            continue;
+        }
+        Result.One |= ((KBInstance.One >> (i + ShiftAmt)) & 1) << i;
+        Result.Zero |= ((KBInstance.Zero >> (i + ShiftAmt)) & 1) << i;
+    }
+    return Result;
+}
+
+// Fixed-width version of ashrComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> ashrCompositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    KnownBitsFixed<N> Result;
+    Result.One = ashrFixed<N>(KBInstance.One, ShiftAmt);
+    Result.Zero = ashrFixed<N>(KBInstance.Zero, ShiftAmt);
+    return Result;
+}
+
+// Fixed-width version of ashrDecomposed
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> ashrDecomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned ShiftAmt) {
+    assert(ShiftAmt < N && "Illegal shift amount");
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        unsigned SrcBit = i + ShiftAmt < N ? i + ShiftAmt : N - 1;
+        Result.One |= ((KBInstance.One >> SrcBit) & 1) << i;
+        Result.Zero |= ((KBInstance.Zero >> SrcBit) & 1) << i;
+    }
+    return Result;
+}
+
+// Fixed-width version of andComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> andCompositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    Result.Zero = LHS.Zero | RHS.Zero;
+    Result.One = LHS.One & RHS.One;
+    return Result;
+}
+
+// Fixed-width version of orComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> orCompositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    Result.Zero = LHS.Zero & RHS.Zero;
+    Result.One = LHS.One | RHS.One;
+    return Result;
+}
+
+// Fixed-width version of xorComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> xorCompositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    Result.Zero = (LHS.Zero & RHS.Zero) | (LHS.One & RHS.One);
+    Result.One = (LHS.Zero & RHS.One) | (LHS.One & RHS.Zero);
+    return Result;
+}
+
+// Fixed-width versions of the bitwise decomposed transfer functions. Every bit
+// position is handled on its own, with a known bit being a set bit in Zero or One.
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> andDecomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t Bit = uint64_t(1) << i;
+        if ((LHS.Zero | RHS.Zero) & Bit)
+            Result.Zero |= Bit;
+        else if (LHS.One & RHS.One & Bit)
+            Result.One |= Bit;
+    }
+    return Result;
+}
+
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> orDecomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t Bit = uint64_t(1) << i;
+        if ((LHS.One | RHS.One) & Bit)
+            Result.One |= Bit;
+        else if (LHS.Zero & RHS.Zero & Bit)
+            Result.Zero |= Bit;
+    }
+    return Result;
+}
+
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> xorDecomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t Bit = uint64_t(1) << i;
+        if (!((LHS.Zero | LHS.One) & Bit) || !((RHS.Zero | RHS.One) & Bit))
+            continue;
+        if (((LHS.One ^ RHS.One) & Bit) != 0)
+            Result.One |= Bit;
+        else
+            Result.Zero |= Bit;
+    }
+    return Result;
+}
+
+// Fixed-width version of addCarryComposite
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> addCarryCompositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS,
+                                                            bool CarryZero, bool CarryOne) {
+    const uint64_t Mask = KnownBitsFixed<N>::mask();
+    uint64_t PossibleSumZero = ((~LHS.Zero & Mask) + (~RHS.Zero & Mask) + !CarryZero) & Mask;
+    uint64_t PossibleSumOne = (LHS.One + RHS.One + CarryOne) & Mask;
+
+    // Compute known bits of the carry
+    uint64_t CarryKnownZero = ~(PossibleSumZero ^ LHS.Zero ^ RHS.Zero) & Mask;
+    uint64_t CarryKnownOne = PossibleSumOne ^ LHS.One ^ RHS.One;
+
+    // Compute set of known bits (where all three relevant bits are known)
+    uint64_t Known = (LHS.Zero | LHS.One) & (RHS.Zero | RHS.One) & (CarryKnownZero | CarryKnownOne);
+
+    KnownBitsFixed<N> Result;
+    Result.Zero = ~PossibleSumZero & Known;
+    Result.One = PossibleSumOne & Known;
+    return Result;
+}
+
+// Fixed-width version of the ripple-carry decomposed adders. InvertRHS and a
+// known one carry in turn the adder into a subtractor.
+template <unsigned N>
+VERIFY_HOST_DEVICE KnownBitsFixed<N> rippleCarryFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS,
+                                                      bool InvertRHS, bool CarryIn) {
+    uint64_t RHSZero = InvertRHS ? RHS.One : RHS.Zero;
+    uint64_t RHSOne = InvertRHS ? RHS.Zero : RHS.One;
+    bool CarryKnown = true;
+    bool CarryValue = CarryIn;
+    KnownBitsFixed<N> Result;
+    for (unsigned i = 0; i < N; ++i) {
+        uint64_t Bit = uint64_t(1) << i;
+        bool AKnown = (LHS.Zero | LHS.One) & Bit, BKnown = (RHSZero | RHSOne) & Bit;
+        bool AValue = LHS.One & Bit, BValue = RHSOne & Bit;
+        if (AKnown && BKnown && CarryKnown)
+            (AValue ^ BValue ^ CarryValue ? Result.One : Result.Zero) |= Bit;
+
+        unsigned NumOnes = (AKnown && AValue) + (BKnown && BValue) + (CarryKnown && CarryValue);
+        unsigned NumZeros = (AKnown && !AValue) + (BKnown && !BValue) + (CarryKnown && !CarryValue);
+        CarryKnown = NumOnes >= 2 || NumZeros >= 2;
+        CarryValue = NumOnes >= 2;
+    }
+    return Result;
+}
+
+// Function to compare two fixed-width values in the lattice order, see comparePrecision
+template <unsigned N>
+VERIFY_HOST_DEVICE constexpr PrecisionOrder comparePrecisionFixed(const KnownBitsFixed<N> &A,
+                                                                  const KnownBitsFixed<N> &B) {
+    bool AInB = (B.Zero & ~A.Zero) == 0 && (B.One & ~A.One) == 0;
+    bool BInA = (A.Zero & ~B.Zero) == 0 && (A.One & ~B.One) == 0;
+
+    if (AInB && BInA)
+        return PrecisionOrder::Equal;
+    if (AInB)
+        return PrecisionOrder::FirstMorePrecise;
+    if (BInA)
+        return PrecisionOrder::SecondMorePrecise;
+    return PrecisionOrder::Incomparable;
+}
+
+#endif // KNOWN_BITS_FIXED_H
@@ -1,16 +1,597 @@
-// Comparing and testing the composed and decomposed versions of the sextInReg transfer function from LLVM KnownBits class
+// Comparing and testing the composite and decomposed versions of transfer functions from the LLVM KnownBits class.
+// A registry of unary (sextInReg, zextInReg, shl, lshr, ashr) and binary (and, or, xor, add, sub) operations is
+// swept exhaustively over the abstract domain on the APInt, fixed-width, batched and CUDA backends, or decided
+// symbolically with Z3, and the precision of both results is compared in the KnownBits lattice.
 
 #include <llvm/ADT/APInt.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
 #include <llvm/Support/KnownBits.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/MathExtras.h>
 #include <vector>
+#include <string>
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <utility>
 #include <set>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "known_bits_fixed.h"
+#ifdef VERIFY_WITH_Z3
+#include <z3.h>
+#endif
+
+#ifdef VERIFY_WITH_CUDA
+// Defined in sweep_gpu.cu, compiled with nvcc
+extern "C" int sweepUnaryOnGPU(const char *Name, unsigned BitWidth, unsigned Param, uint64_t Begin, uint64_t End,
+                               uint64_t Counts[4], uint8_t *Orders, char *Error, size_t ErrorSize);
+#endif
 
 using namespace llvm;
 
+// Largest bitwidth whose abstract domain can still be indexed by a uint64_t
+static const unsigned MaxExhaustiveBitWidth = 40;
+
+// Largest bitwidth accepted by the symbolic backend, which does not enumerate
+static const unsigned MaxSymbolicBitWidth = 128;
+
+// Largest bitwidth accepted by --sample
+static const unsigned MaxSampledBitWidth = 256;
+
+// Largest bitwidth concretized into a ConcreteValueSet, 2MB per set
+static const unsigned MaxBitsetConcretizationBitWidth = 24;
+
+// Largest bitwidths for which --optimal and --soundness tabulate the concrete
+// operation, 2^24 concrete inputs either way
+static const unsigned MaxOptimalBitWidth = 24;
+static const unsigned MaxOptimalBinaryBitWidth = 12;
+
+// Largest bitwidth --bench accepts. Every stage keeps the whole domain and
+// both results in memory.
+static const unsigned MaxBenchBitWidth = 14;
+
+// Formats of the per-configuration reports
+enum class OutputFormat { Text, JSON, CSV };
+
+// Scheduling of the configurations of a run: one parallel sweep after another,
+// or all of them at once on the work-stealing grid scheduler
+enum class Schedule { Config, Grid };
+
+// Representation used to evaluate the transfer functions
+enum class Backend {
+    APInt,  // llvm::KnownBits on APInt, any bitwidth
+    Fixed,  // KnownBitsFixed<N> on machine words, bitwidths up to 64
+    Batched, // Fixed-width words evaluated in vectorizable batches, bitwidths up to 64
+    SMT,     // Symbolic Zero/One bitvectors decided by Z3, needs -DVERIFY_WITH_Z3
+    GPU      // CUDA kernels of the fixed-width unary functions, needs -DVERIFY_WITH_CUDA
+};
+
+// Command-line configuration of a verification run
+struct VerifyOptions {
+    bool CrossCheck = false;     // Cross-check the lattice comparison against concretizations
+    bool Differential = false;   // Check the fixed-width backend against the APInt backend
+    bool Library = false;        // Check the composite functions against the linked LLVM's KnownBits
+    bool Optimal = false;        // Compare both functions against the optimal transformer
+    bool Soundness = false;      // Check both results against every concrete outcome
+    bool Distance = false;       // Report histograms of the precision distance
+    bool Generalize = false;     // Derive configurations from the input bits their functions read
+    bool GroupByMask = false;    // Settle the inputs sharing an unknown-bit mask together
+    bool FindFirst = false;      // Stop at the first input the decomposed function handles better
+    bool SkipStatic = false;     // Report the configurations checked at compile time without sweeping them
+    unsigned SampleBudget = 0;   // Inputs drawn per configuration instead of sweeping, 0 sweeps
+    bool Stratified = false;     // Spread the samples evenly over the numbers of unknown bits
+    uint64_t Seed = 1;           // Seed of the sample generators
+    std::string CheckpointPath;  // File saving the progress of the run, empty for none
+    unsigned CheckpointInterval = 60; // Seconds between checkpoint saves
+    bool Resume = false;         // Continue from the checkpoint file
+    unsigned ShardIndex = 0;     // Part of every sweep run by this process, of ShardCount
+    unsigned ShardCount = 0;     // Number of parts the sweeps are split into, 0 runs them whole
+    std::vector<std::string> MergePaths; // Shard files to combine instead of sweeping
+    OutputFormat Format = OutputFormat::Text;
+    Schedule SelectedSchedule = Schedule::Config;
+    std::string StorePath;       // File receiving the order of every unary input, empty for none
+    std::string DiffPath;        // Store of an earlier run to compare every unary input against
+    std::string CachePath;       // Counters of earlier runs to reuse where fingerprints match
+    bool Bench = false;          // Time the stages of each unary configuration instead of verifying
+    unsigned Repetitions = 5;    // Timed runs per configuration for --bench
+    unsigned NumThreads = 0;     // Worker threads, 0 uses every hardware thread
+    unsigned MinBitWidth = 4;
+    unsigned MaxBitWidth = 8;
+    std::vector<std::pair<unsigned, unsigned>> ParamRanges; // Inclusive ranges of parameters to sweep, empty for all
+    Backend SelectedBackend = Backend::APInt;
+    std::vector<std::string> OperationNames; // Registered operations to verify, or "all"
+    bool ListOperations = false;
+};
+
+static VerifyOptions Options;
+
+// Instrumentation of the hot paths, compiled in with -DVERIFY_STATS. Without it
+// the VERIFY_STAT macros expand to nothing and their arguments are not
+// evaluated, so production sweeps pay nothing.
+#ifdef VERIFY_STATS
+// Workers whose busy and idle times are kept; later ones share the last slot
+static const unsigned MaxStatsWorkers = 64;
+
+struct VerifyStats {
+    std::atomic<uint64_t> ConcretizeCalls{0};     // concretize into a std::set
+    std::atomic<uint64_t> SetInsertions{0};       // Values inserted into those sets
+    std::atomic<uint64_t> BitsetConcretizations{0};
+    std::atomic<uint64_t> BitsetInsertions{0};
+    std::atomic<uint64_t> HeapAllocations{0};     // Every operator new, APInt words above 64 bits included
+    std::atomic<uint64_t> HeapBytes{0};
+    std::atomic<uint64_t> EnumeratedBytes{0};     // Largest domain materialized by enumerateKnownBits
+    std::atomic<uint64_t> ParallelRegions{0};     // Calls of parallelForChunks
+    std::atomic<uint64_t> WorkerBusyNanos[MaxStatsWorkers] = {};
+    std::atomic<uint64_t> WorkerIdleNanos[MaxStatsWorkers] = {};
+};
+
+static VerifyStats Stats;
+
+#define VERIFY_STAT(Counter, Amount) (Stats.Counter.fetch_add((Amount), std::memory_order_relaxed))
+#define VERIFY_STAT_MAX(Counter, Value)                                                                      \
+    do {                                                                                                     \
+        uint64_t StatValue = (Value), StatPrev = Stats.Counter.load(std::memory_order_relaxed);              \
+        while (StatPrev < StatValue && !Stats.Counter.compare_exchange_weak(StatPrev, StatValue))            \
+            ;                                                                                                \
+    } while (false)
+#else
+#define VERIFY_STAT(Counter, Amount) ((void)0)
+#define VERIFY_STAT_MAX(Counter, Value) ((void)0)
+#endif
+
+static void printUsage(raw_ostream &OS, const char *Program) {
+    OS << "Usage: " << Program << " [options]\n"
+       << "  --cross-check   Also compare results through their concretizations\n"
+       << "  --threads N     Number of worker threads (0 uses every hardware thread)\n"
+       << "  --backend B     Evaluate with 'apint' (default), or with 'fixed' or 'simd'\n"
+       << "                  (bitwidths <= 64), or decide each configuration with 'smt'\n"
+       << "                  (unary operations, bitwidths <= " << MaxSymbolicBitWidth << ", built with -DVERIFY_WITH_Z3),\n"
+       << "                  or sweep unary operations on a CUDA device with 'gpu' (built with -DVERIFY_WITH_CUDA)\n"
+       << "  --differential  Check every fixed-width result against the APInt backend, and with\n"
+       << "                  'gpu' every GPU order against the fixed backend\n"
+       << "  --llvm          Also run the KnownBits functions of the linked LLVM and count the composite\n"
+       << "                  results that differ from them\n"
+       << "  --optimal       Also compare both functions against the best abstract transformer\n"
+       << "  --soundness     Also check that both results admit f(v) for every concrete value v of\n"
+       << "                  the input (bitwidths <= " << MaxOptimalBitWidth << ", " << MaxOptimalBinaryBitWidth
+       << " for binary operations)\n"
+       << "  --distance      Also report how many known bits the composite result loses, as a histogram\n"
+       << "  --generalize    Sweep only the input bits a unary operation reads and scale the counts\n"
+       << "  --group-by-mask Enumerate unary inputs by unknown-bit mask and settle each mask's inputs\n"
+       << "                  at once where their results provably compare alike\n"
+       << "  --sample N      Draw N random inputs per configuration instead of sweeping, and report\n"
+       << "                  estimated frequencies with 95% confidence intervals (bitwidths <= " << MaxSampledBitWidth << ")\n"
+       << "  --stratified    Spread the samples evenly over the numbers of unknown bits\n"
+       << "  --seed N        Seed of the sample generators (default 1)\n"
+       << "  --checkpoint FILE\n"
+       << "                  Save the progress of the sweeps to FILE periodically\n"
+       << "  --checkpoint-interval S\n"
+       << "                  Seconds between checkpoint saves (default 60)\n"
+       << "  --resume        Continue from the checkpoint FILE if it exists\n"
+       << "  --shard I/N     Sweep only part I of N of every configuration and print its counters\n"
+       << "                  for --merge\n"
+       << "  --merge FILE... Combine the output files of shards 0 to N-1 of a run with these options\n"
+       << "  --format F      Print reports as 'text' (default), 'json' lines or 'csv' rows,\n"
+       << "                  with the wall time of each configuration\n"
+       << "  --schedule S    Sweep the configurations one after another ('config', default), or all\n"
+       << "                  at once with work stealing between them ('grid')\n"
+       << "  --store FILE    Write the precision order of every unary input to FILE, 2 bits each\n"
+       << "  --diff FILE     Count the unary inputs whose order differs from the store FILE\n"
+       << "  --incremental FILE\n"
+       << "                  Reuse the counters cached in FILE for configurations whose functions are\n"
+       << "                  unchanged, and cache the ones swept\n"
+       << "  --bench         Time each stage of every unary configuration, single threaded\n"
+       << "                  (bitwidths <= " << MaxBenchBitWidth << ")\n"
+       << "  --repetitions N Timed runs per configuration for --bench (default 5)\n"
+       << "  --find-first    Stop at the first input whose composite result is less precise than the\n"
+       << "                  decomposed one or incomparable with it, print it and exit with status 1\n"
+       << "  --skip-static   Report the configurations verified at compile time (sextInReg up to 6 bits)\n"
+       << "                  without sweeping them\n"
+       << "  --min-bitwidth N, --max-bitwidth N\n"
+       << "                  Range of bitwidths to sweep (default 4 to 8)\n"
+       << "  --param P[,P...]\n"
+       << "                  Parameters (SrcBitWidth, shift amount) to sweep, each a value or a range\n"
+       << "                  A-B; values outside a bitwidth's range are skipped (default all)\n"
+       << "  --op NAME[,NAME...]\n"
+       << "                  Operations to verify, or 'all' (default sextInReg)\n"
+       << "  --list-ops      List the registered operations\n"
+       << "  --help          Print this message\n";
+}
+
+// Function to parse the command line into Options, accepting both "--opt value"
+// and "--opt=value". Returns false if the command line is malformed.
+bool parseOptions(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        StringRef Arg(argv[i]);
+        StringRef Value;
+        bool HasInlineValue = false;
+        if (Arg.startswith("--") && Arg.contains('=')) {
+            std::pair<StringRef, StringRef> Split = Arg.split('=');
+            Arg = Split.first;
+            Value = Split.second;
+            HasInlineValue = true;
+        }
+
+        // Fetch the value of an option that takes one
+        auto getValue = [&](StringRef &Out) {
+            if (HasInlineValue) {
+                Out = Value;
+                return true;
+            }
+            if (i + 1 >= argc) {
+                errs() << "error: missing value for " << Arg << "\n";
+                return false;
+            }
+            Out = argv[++i];
+            return true;
+        };
+        // Fetch the value of an option that takes an unsigned integer
+        auto getUnsigned = [&](unsigned &Out) {
+            StringRef Text;
+            if (!getValue(Text))
+                return false;
+            if (Text.getAsInteger(10, Out)) {
+                errs() << "error: invalid value '" << Text << "' for " << Arg << "\n";
+                return false;
+            }
+            return true;
+        };
+
+        if (Arg == "--help" || Arg == "-h") {
+            printUsage(outs(), argv[0]);
+            exit(0);
+        } else if (Arg == "--cross-check") {
+            Options.CrossCheck = true;
+        } else if (Arg == "--threads") {
+            if (!getUnsigned(Options.NumThreads))
+                return false;
+        } else if (Arg == "--backend") {
+            StringRef Name;
+            if (!getValue(Name))
+                return false;
+            if (Name == "apint") {
+                Options.SelectedBackend = Backend::APInt;
+            } else if (Name == "fixed") {
+                Options.SelectedBackend = Backend::Fixed;
+            } else if (Name == "simd") {
+                Options.SelectedBackend = Backend::Batched;
+            } else if (Name == "smt") {
+#ifdef VERIFY_WITH_Z3
+                Options.SelectedBackend = Backend::SMT;
+#else
+                errs() << "error: the smt backend needs a build with -DVERIFY_WITH_Z3\n";
+                return false;
+#endif
+            } else if (Name == "gpu") {
+#ifdef VERIFY_WITH_CUDA
+                Options.SelectedBackend = Backend::GPU;
+#else
+                errs() << "error: the gpu backend needs a build with -DVERIFY_WITH_CUDA and sweep_gpu.cu\n";
+                return false;
+#endif
+            } else {
+                errs() << "error: unknown backend '" << Name << "'\n";
+                return false;
+            }
+        } else if (Arg == "--differential") {
+            Options.Differential = true;
+        } else if (Arg == "--llvm") {
+            Options.Library = true;
+        } else if (Arg == "--optimal") {
+            Options.Optimal = true;
+        } else if (Arg == "--soundness") {
+            Options.Soundness = true;
+        } else if (Arg == "--distance") {
+            Options.Distance = true;
+        } else if (Arg == "--generalize") {
+            Options.Generalize = true;
+        } else if (Arg == "--group-by-mask") {
+            Options.GroupByMask = true;
+        } else if (Arg == "--find-first") {
+            Options.FindFirst = true;
+        } else if (Arg == "--skip-static") {
+            Options.SkipStatic = true;
+        } else if (Arg == "--sample") {
+            if (!getUnsigned(Options.SampleBudget))
+                return false;
+        } else if (Arg == "--checkpoint") {
+            StringRef Path;
+            if (!getValue(Path))
+                return false;
+            Options.CheckpointPath = Path.str();
+        } else if (Arg == "--checkpoint-interval") {
+            if (!getUnsigned(Options.CheckpointInterval))
+                return false;
+        } else if (Arg == "--resume") {
+            Options.Resume = true;
+        } else if (Arg == "--shard") {
+            StringRef Text;
+            if (!getValue(Text))
+                return false;
+            std::pair<StringRef, StringRef> Split = Text.split('/');
+            if (Split.first.getAsInteger(10, Options.ShardIndex) || Split.second.getAsInteger(10, Options.ShardCount) ||
+                Options.ShardIndex >= Options.ShardCount) {
+                errs() << "error: invalid shard '" << Text << "', expected I/N with I < N\n";
+                return false;
+            }
+        } else if (Arg == "--merge") {
+            while (i + 1 < argc && !StringRef(argv[i + 1]).startswith("-"))
+                Options.MergePaths.push_back(argv[++i]);
+            if (Options.MergePaths.empty()) {
+                errs() << "error: --merge needs at least one shard file\n";
+                return false;
+            }
+        } else if (Arg == "--format") {
+            StringRef Name;
+            if (!getValue(Name))
+                return false;
+            if (Name == "text") {
+                Options.Format = OutputFormat::Text;
+            } else if (Name == "json") {
+                Options.Format = OutputFormat::JSON;
+            } else if (Name == "csv") {
+                Options.Format = OutputFormat::CSV;
+            } else {
+                errs() << "error: unknown format '" << Name << "'\n";
+                return false;
+            }
+        } else if (Arg == "--schedule") {
+            StringRef Name;
+            if (!getValue(Name))
+                return false;
+            if (Name == "config") {
+                Options.SelectedSchedule = Schedule::Config;
+            } else if (Name == "grid") {
+                Options.SelectedSchedule = Schedule::Grid;
+            } else {
+                errs() << "error: unknown schedule '" << Name << "'\n";
+                return false;
+            }
+        } else if (Arg == "--store" || Arg == "--diff") {
+            StringRef Path;
+            if (!getValue(Path))
+                return false;
+            (Arg == "--store" ? Options.StorePath : Options.DiffPath) = Path.str();
+        } else if (Arg == "--incremental") {
+            StringRef Path;
+            if (!getValue(Path))
+                return false;
+            Options.CachePath = Path.str();
+        } else if (Arg == "--bench") {
+            Options.Bench = true;
+        } else if (Arg == "--repetitions") {
+            if (!getUnsigned(Options.Repetitions))
+                return false;
+        } else if (Arg == "--stratified") {
+            Options.Stratified = true;
+        } else if (Arg == "--seed") {
+            StringRef Text;
+            if (!getValue(Text))
+                return false;
+            if (Text.getAsInteger(10, Options.Seed)) {
+                errs() << "error: invalid value '" << Text << "' for " << Arg << "\n";
+                return false;
+            }
+        } else if (Arg == "--op") {
+            StringRef Names;
+            if (!getValue(Names))
+                return false;
+            SmallVector<StringRef, 8> Split;
+            Names.split(Split, ',', -1, false);
+            for (StringRef Name : Split)
+                Options.OperationNames.push_back(Name.str());
+        } else if (Arg == "--list-ops") {
+            Options.ListOperations = true;
+        } else if (Arg == "--min-bitwidth") {
+            if (!getUnsigned(Options.MinBitWidth))
+                return false;
+        } else if (Arg == "--max-bitwidth") {
+            if (!getUnsigned(Options.MaxBitWidth))
+                return false;
+        } else if (Arg == "--param") {
+            StringRef Text;
+            if (!getValue(Text))
+                return false;
+            SmallVector<StringRef, 8> Split;
+            Text.split(Split, ',', -1, false);
+            for (StringRef Item : Split) {
+                std::pair<StringRef, StringRef> Bounds = Item.split('-');
+                if (Bounds.second.empty())
+                    Bounds.second = Bounds.first;
+                std::pair<unsigned, unsigned> Range;
+                if (Bounds.first.getAsInteger(10, Range.first) || Bounds.second.getAsInteger(10, Range.second) ||
+                    Range.first > Range.second) {
+                    errs() << "error: invalid parameter '" << Item << "', expected a value or a range A-B\n";
+                    return false;
+                }
+                Options.ParamRanges.push_back(Range);
+            }
+            if (Options.ParamRanges.empty()) {
+                errs() << "error: --param needs at least one value\n";
+                return false;
+            }
+        } else {
+            errs() << "error: unknown option '" << argv[i] << "'\n";
+            return false;
+        }
+    }
+
+    if (Options.OperationNames.empty())
+        Options.OperationNames.push_back("sextInReg");
+    if (Options.MinBitWidth == 0 || Options.MinBitWidth > Options.MaxBitWidth) {
+        errs() << "error: invalid bitwidth range " << Options.MinBitWidth << ".." << Options.MaxBitWidth << "\n";
+        return false;
+    }
+    if (Options.Bench) {
+        if (Options.SampleBudget != 0 || Options.FindFirst || Options.Generalize || Options.Optimal ||
+            Options.CrossCheck || Options.Differential || Options.Distance || Options.Soundness ||
+            Options.Library || Options.GroupByMask || Options.SelectedSchedule != Schedule::Config ||
+            Options.SelectedBackend != Backend::APInt || !Options.CheckpointPath.empty() ||
+            Options.ShardCount != 0 || !Options.MergePaths.empty() || !Options.StorePath.empty() ||
+            !Options.DiffPath.empty() || !Options.CachePath.empty()) {
+            errs() << "error: --bench takes only --op, the bitwidths, --repetitions and --format\n";
+            return false;
+        }
+        if (Options.Repetitions == 0 || Options.MaxBitWidth > MaxBenchBitWidth) {
+            errs() << "error: --bench needs at least one repetition and bitwidths up to " << MaxBenchBitWidth
+                   << "\n";
+            return false;
+        }
+        return true;
+    }
+    if (Options.SkipStatic &&
+        (Options.SampleBudget != 0 || Options.FindFirst || Options.Generalize || Options.GroupByMask ||
+         Options.Optimal || Options.Soundness || Options.CrossCheck || Options.Differential || Options.Distance ||
+         Options.SelectedSchedule != Schedule::Config || Options.SelectedBackend == Backend::SMT ||
+         !Options.CheckpointPath.empty() || Options.ShardCount != 0 || !Options.MergePaths.empty() ||
+         !Options.StorePath.empty() || !Options.DiffPath.empty() || !Options.CachePath.empty())) {
+        errs() << "error: --skip-static only proves the precision orders, so it takes plain exhaustive sweeps "
+                  "with --format\n";
+        return false;
+    }
+    if (Options.Library &&
+        (Options.SelectedBackend != Backend::APInt || Options.SampleBudget != 0 || Options.FindFirst ||
+         Options.Generalize || Options.GroupByMask || Options.SkipStatic)) {
+        errs() << "error: --llvm runs in the exhaustive sweeps of the apint backend, without --sample, "
+                  "--find-first, --generalize, --group-by-mask or --skip-static\n";
+        return false;
+    }
+    if (Options.Resume && Options.CheckpointPath.empty()) {
+        errs() << "error: --resume needs --checkpoint FILE\n";
+        return false;
+    }
+    bool KeepsOrders = !Options.StorePath.empty() || !Options.DiffPath.empty();
+    if (KeepsOrders && (!Options.CheckpointPath.empty() || Options.ShardCount != 0 || !Options.MergePaths.empty() ||
+                        Options.Generalize || !Options.CachePath.empty())) {
+        errs() << "error: --store and --diff need a whole sweep, without --checkpoint, --shard, --merge, "
+                  "--generalize or --incremental\n";
+        return false;
+    }
+    if (!Options.CachePath.empty() && (Options.ShardCount != 0 || !Options.MergePaths.empty() || Options.Generalize)) {
+        errs() << "error: --incremental caches whole sweeps, without --shard, --merge or --generalize\n";
+        return false;
+    }
+    if (Options.Format != OutputFormat::Text && Options.ShardCount != 0) {
+        errs() << "error: shards print counter lines for --merge, which takes --format\n";
+        return false;
+    }
+    bool SplitsSweeps = !Options.CheckpointPath.empty() || Options.ShardCount != 0 || !Options.MergePaths.empty() ||
+                        KeepsOrders || Options.Format != OutputFormat::Text || !Options.CachePath.empty();
+    if (SplitsSweeps && (Options.SampleBudget != 0 || Options.FindFirst || Options.Generalize ||
+                         Options.GroupByMask || Options.SelectedBackend == Backend::SMT)) {
+        errs() << "error: --checkpoint, --shard, --merge, --format, --store, --diff and --incremental "
+                  "apply to exhaustive sweeps\n";
+        return false;
+    }
+    bool PerConfig = !Options.CheckpointPath.empty() || Options.ShardCount != 0 || !Options.MergePaths.empty() ||
+                     KeepsOrders || !Options.CachePath.empty() || Options.SampleBudget != 0 || Options.FindFirst ||
+                     Options.Generalize || Options.GroupByMask || Options.Optimal || Options.Soundness ||
+                     Options.SelectedBackend == Backend::SMT || Options.SelectedBackend == Backend::GPU;
+    if (Options.SelectedSchedule == Schedule::Grid && PerConfig) {
+        errs() << "error: --schedule grid takes only exhaustive sweeps with --cross-check, --differential, "
+                  "--distance or --format\n";
+        return false;
+    }
+    if (!Options.MergePaths.empty() && (Options.ShardCount != 0 || !Options.CheckpointPath.empty())) {
+        errs() << "error: --merge does not sweep, so it takes no --shard or --checkpoint\n";
+        return false;
+    }
+    if (Options.Stratified && Options.SampleBudget == 0) {
+        errs() << "error: --stratified needs --sample\n";
+        return false;
+    }
+    if (Options.SampleBudget != 0) {
+        if (Options.SelectedBackend != Backend::APInt || Options.Optimal || Options.Generalize ||
+            Options.GroupByMask || Options.FindFirst || Options.Differential || Options.Distance ||
+            Options.Soundness) {
+            errs() << "error: --sample runs on the apint backend without --optimal, --generalize, "
+                      "--group-by-mask, --find-first, --differential, --distance or --soundness\n";
+            return false;
+        }
+        if (Options.MaxBitWidth > MaxSampledBitWidth) {
+            errs() << "error: --sample supports bitwidths up to " << MaxSampledBitWidth << "\n";
+            return false;
+        }
+        if (Options.CrossCheck && Options.MaxBitWidth > MaxBitsetConcretizationBitWidth) {
+            errs() << "error: --cross-check supports sampled bitwidths up to "
+                   << MaxBitsetConcretizationBitWidth << "\n";
+            return false;
+        }
+        return true;
+    }
+    if (Options.FindFirst && (Options.SelectedBackend != Backend::APInt || Options.Optimal || Options.Generalize ||
+                              Options.GroupByMask || Options.CrossCheck || Options.Differential ||
+                              Options.Soundness)) {
+        errs() << "error: --find-first runs alone on the apint backend\n";
+        return false;
+    }
+    if (Options.Generalize && (Options.Optimal || Options.SelectedBackend == Backend::SMT)) {
+        errs() << "error: --generalize cannot be combined with --optimal or the smt backend\n";
+        return false;
+    }
+    if (Options.GroupByMask && (Options.SelectedBackend != Backend::APInt || Options.Generalize ||
+                                Options.Optimal || Options.Differential)) {
+        errs() << "error: --group-by-mask runs on the apint backend without --generalize, --optimal or "
+                  "--differential\n";
+        return false;
+    }
+    if (Options.Soundness && (Options.Optimal || Options.Generalize || Options.GroupByMask)) {
+        errs() << "error: --soundness checks every input, without --generalize or --group-by-mask; "
+                  "--optimal already counts unsound results\n";
+        return false;
+    }
+    if (Options.SelectedBackend == Backend::GPU &&
+        (Options.CrossCheck || Options.Optimal || Options.Soundness || Options.Distance || Options.Generalize ||
+         KeepsOrders)) {
+        errs() << "error: the gpu backend only counts the precision orders, checked against the fixed backend "
+                  "with --differential, without --cross-check, --optimal, --soundness, --distance, --generalize, "
+                  "--store or --diff\n";
+        return false;
+    }
+    if (Options.SelectedBackend == Backend::SMT) {
+        if (Options.MaxBitWidth > MaxSymbolicBitWidth) {
+            errs() << "error: the smt backend supports bitwidths up to " << MaxSymbolicBitWidth << "\n";
+            return false;
+        }
+        if (Options.CrossCheck || Options.Differential || Options.Optimal || Options.Soundness) {
+            errs() << "error: --cross-check, --differential, --optimal and --soundness need an enumerating "
+                      "backend\n";
+            return false;
+        }
+        return true;
+    }
+    if (Options.MaxBitWidth > MaxExhaustiveBitWidth) {
+        errs() << "error: bitwidths above " << MaxExhaustiveBitWidth << " cannot be swept exhaustively\n";
+        return false;
+    }
+    if ((Options.SelectedBackend != Backend::APInt || Options.Differential) && Options.MaxBitWidth > 64) {
+        errs() << "error: the fixed-width backend supports bitwidths up to 64\n";
+        return false;
+    }
+    return true;
+}
+
 // Custom comparator for APInt to enable < for std::set
 struct APIntComparator {
     bool operator()(const llvm::APInt &lhs, const llvm::APInt &rhs) const {
@@ -20,40 +601,237 @@ struct APIntComparator {
 
 // Helper function to count bits set to one in an APInt
 unsigned countSetBits(const APInt &Value) {
-    unsigned count = 0;
-    unsigned BitWidth = Value.getBitWidth();
-    for (unsigned i = 0; i < BitWidth; ++i) {
-        if (Value[i]) {
-            ++count;
-        }
+    return Value.countPopulation(); // Hardware popcount on each word
+}
+
+// Function to count the abstract values for a given bitwidth, 3^BitWidth,
+// exactly in integers; only bitwidths whose domain fits a uint64_t are counted
+constexpr uint64_t numAbstractValues(unsigned BitWidth) {
+    assert(BitWidth <= MaxExhaustiveBitWidth && "Abstract domain too large to count");
+    uint64_t NumValues = 1;
+    for (unsigned Bit = 0; Bit < BitWidth; ++Bit)
+        NumValues *= 3;
+    return NumValues;
+}
+
+// Function to decode the base-3 index of an abstract value into KBInstance, see
+// decodeKnownBitsMasks. Indices have at most 41 base-3 digits, so the bits
+// above 64 are always known zero.
+void decodeKnownBits(uint64_t Index, KnownBits &KBInstance) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    uint64_t Zero, One;
+    decodeKnownBitsMasks(Index, std::min(BitWidth, 64u), Zero, One);
+    if (BitWidth <= 64) {
+        KBInstance.Zero = Zero;
+        KBInstance.One = One;
+        return;
     }
-    return count;
+    KBInstance.Zero.clearAllBits();
+    KBInstance.One.clearAllBits();
+    KBInstance.Zero.insertBits(Zero, 0, 64);
+    KBInstance.One.insertBits(One, 0, 64);
+    KBInstance.Zero.setBitsFrom(64);
 }
 
-// Function to enumerate all possible KnownBits values for a given bitwidth
+// Function to advance Zero/One masks of BitWidth <= 64 bits to the abstract value
+// with the next base-3 index. The trailing unknown digits wrap to known zero and
+// carry into the first known digit, which steps from 0 to 1 or from 1 to X.
+inline void incrementKnownBitsMasks(uint64_t &Zero, uint64_t &One, unsigned BitWidth) {
+    uint64_t Unknown = ~(Zero | One) & maskTrailingOnes<uint64_t>(BitWidth);
+    unsigned Carry = countTrailingOnes(Unknown);
+    Zero |= maskTrailingOnes<uint64_t>(Carry);
+    if (Carry == BitWidth)
+        return;
+    uint64_t Digit = uint64_t(1) << Carry;
+    if (Zero & Digit) {
+        Zero &= ~Digit;
+        One |= Digit;
+    } else {
+        One &= ~Digit;
+    }
+}
+
+// Lazy range over the abstract values with base-3 indices in [Begin, End).
+// Values are produced in index order by a base-3 counter kept directly in the
+// Zero/One masks: incrementing touches only the digits that change (1.5 on
+// average), so a scan needs O(1) memory and no per-value allocation.
+class KnownBitsRange {
+public:
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef KnownBits value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const KnownBits *pointer;
+        typedef const KnownBits &reference;
+
+        iterator(unsigned BitWidth, uint64_t Index) : Index(Index), Current(BitWidth) {
+            decodeKnownBits(Index, Current);
+        }
+
+        const KnownBits &operator*() const { return Current; }
+        const KnownBits *operator->() const { return &Current; }
+        uint64_t index() const { return Index; }
+
+        iterator &operator++() {
+            ++Index;
+            // Up to 64 bits the counter runs on the machine words of the masks
+            unsigned BitWidth = Current.getBitWidth();
+            if (BitWidth <= 64) {
+                uint64_t Zero = Current.Zero.getZExtValue(), One = Current.One.getZExtValue();
+                incrementKnownBitsMasks(Zero, One, BitWidth);
+                Current.Zero = Zero;
+                Current.One = One;
+                return *this;
+            }
+            // Digit order is 0 -> 1 -> X, and X wraps back to 0 with a carry
+            for (unsigned Bit = 0; Bit < BitWidth; ++Bit) {
+                if (Current.Zero[Bit]) {
+                    Current.Zero.clearBit(Bit);
+                    Current.One.setBit(Bit);
+                    break;
+                }
+                if (Current.One[Bit]) {
+                    Current.One.clearBit(Bit);
+                    break;
+                }
+                Current.Zero.setBit(Bit);
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator &Other) const { return Index == Other.Index; }
+        bool operator!=(const iterator &Other) const { return Index != Other.Index; }
+
+    private:
+        uint64_t Index;
+        KnownBits Current;
+    };
+
+    KnownBitsRange(unsigned BitWidth, uint64_t Begin, uint64_t End)
+        : BitWidth(BitWidth), Begin(Begin), End(End) {
+        assert(Begin <= End && End <= numAbstractValues(BitWidth) && "Invalid abstract value range");
+    }
+
+    // The whole abstract domain of the given bitwidth
+    explicit KnownBitsRange(unsigned BitWidth)
+        : KnownBitsRange(BitWidth, 0, numAbstractValues(BitWidth)) {}
+
+    // The end iterator only carries an index, so it is created without decoding
+    iterator begin() const { return iterator(BitWidth, Begin); }
+    iterator end() const { return iterator(0, End); }
+    uint64_t size() const { return End - Begin; }
+
+private:
+    unsigned BitWidth;
+    uint64_t Begin;
+    uint64_t End;
+};
+
+// Function to enumerate all possible KnownBits values for a given bitwidth.
+// This materializes the whole domain; sweeps should iterate a KnownBitsRange instead.
 void enumerateKnownBits(unsigned BitWidth, std::vector<KnownBits> &KnownBitsList) {
-    uint64_t NumAbstractValues = pow(3, BitWidth); // 3^BitWidth possible abstract values
-    KnownBitsList.reserve(NumAbstractValues);
-
-    // Each bit can be 0 (known zero), 1 (known one), or X (unknown)
-    // Represent each abstract value as a number in base 3
-    for (uint64_t i = 0; i < NumAbstractValues; ++i) {
-        KnownBits KBInstance(BitWidth);
-        uint64_t AbsVal = i;
-        bool Valid = true;
-        for (unsigned Bit = 0; Bit < BitWidth; ++Bit) {
-            unsigned Rem = AbsVal % 3;
-            if (Rem == 0) {
+    KnownBitsRange Domain(BitWidth);
+    KnownBitsList.reserve(Domain.size());
+    for (const KnownBits &KBInstance : Domain)
+        KnownBitsList.push_back(KBInstance);
+    VERIFY_STAT_MAX(EnumeratedBytes, KnownBitsList.capacity() * sizeof(KnownBits) +
+                                         (BitWidth > 64 ? KnownBitsList.size() * 2 * divideCeil(BitWidth, 64) * 8 : 0));
+}
+
+// splitmix64, a small and fast generator. Every chunk of samples seeds its own,
+// so the samples drawn do not depend on the number of threads.
+struct SplitMix64 {
+    uint64_t State;
+
+    explicit SplitMix64(uint64_t Seed) : State(Seed) {}
+
+    uint64_t next() {
+        uint64_t Z = (State += 0x9e3779b97f4a7c15ULL);
+        Z = (Z ^ (Z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        Z = (Z ^ (Z >> 27)) * 0x94d049bb133111ebULL;
+        return Z ^ (Z >> 31);
+    }
+};
+
+// Random bits drawn from a generator a word at a time
+class RandomBits {
+public:
+    explicit RandomBits(uint64_t Seed) : Gen(Seed) {}
+
+    // Function to draw NumBits <= 64 uniformly random bits
+    uint64_t draw(unsigned NumBits) {
+        if (Left < NumBits) {
+            Word = Gen.next();
+            Left = 64;
+        }
+        uint64_t Result = Word & maskTrailingOnes<uint64_t>(NumBits);
+        Word = NumBits == 64 ? 0 : Word >> NumBits;
+        Left -= NumBits;
+        return Result;
+    }
+
+    // Function to draw a uniformly random trit: 0, 1 or 2 for unknown. Pairs of
+    // bits equal to 3 are rejected so the three values are exactly equally likely.
+    unsigned drawTrit() {
+        for (;;) {
+            unsigned Pair = draw(2);
+            if (Pair != 3)
+                return Pair;
+        }
+    }
+
+    // Function to draw a uniformly random integer below Bound
+    uint64_t below(uint64_t Bound) { return Gen.next() % Bound; }
+
+private:
+    SplitMix64 Gen;
+    uint64_t Word = 0;
+    unsigned Left = 0;
+};
+
+// Function to set every bit of the operands to known zero, known one or unknown
+// with equal probability, which draws abstract values uniformly from the domain
+void sampleUniform(RandomBits &Random, KnownBits *Operands, unsigned NumOperands) {
+    for (unsigned Operand = 0; Operand < NumOperands; ++Operand) {
+        KnownBits &KBInstance = Operands[Operand];
+        KBInstance.Zero.clearAllBits();
+        KBInstance.One.clearAllBits();
+        for (unsigned Bit = 0; Bit < KBInstance.getBitWidth(); ++Bit) {
+            unsigned Rem = Random.drawTrit();
+            if (Rem == 0)
                 KBInstance.Zero.setBit(Bit);
-            } else if (Rem == 1) {
+            else if (Rem == 1)
                 KBInstance.One.setBit(Bit);
-            } else if (Rem == 2) {
-                // Unknown bit, do nothing
-            }
-            AbsVal = AbsVal / 3;
         }
-        if (Valid)
-            KnownBitsList.push_back(KBInstance);
+    }
+}
+
+// Function to draw operands uniformly among those with exactly NumUnknown unknown
+// bits in total. The unknown positions are a uniformly random subset, chosen with
+// a partial Fisher-Yates shuffle of Positions, and every other bit is a random
+// known value.
+void sampleWithUnknownBits(RandomBits &Random, unsigned NumUnknown, std::vector<unsigned> &Positions,
+                           KnownBits *Operands, unsigned NumOperands) {
+    unsigned BitWidth = Operands[0].getBitWidth();
+    unsigned InputBits = NumOperands * BitWidth;
+    Positions.resize(InputBits);
+    for (unsigned i = 0; i < InputBits; ++i)
+        Positions[i] = i;
+    for (unsigned i = 0; i < NumUnknown; ++i)
+        std::swap(Positions[i], Positions[i + Random.below(InputBits - i)]);
+
+    for (unsigned Operand = 0; Operand < NumOperands; ++Operand) {
+        Operands[Operand].Zero.clearAllBits();
+        Operands[Operand].One.clearAllBits();
+    }
+    for (unsigned i = NumUnknown; i < InputBits; ++i) {
+        KnownBits &KBInstance = Operands[Positions[i] / BitWidth];
+        unsigned Bit = Positions[i] % BitWidth;
+        if (Random.draw(1))
+            KBInstance.One.setBit(Bit);
+        else
+            KBInstance.Zero.setBit(Bit);
     }
 }
 
@@ -65,6 +843,8 @@ void concretize(const KnownBits &KBInstance, std::set<APInt, APIntComparator> &C
     unsigned NumUnknownBits = BitWidth - (NumKnownZeroBits + NumKnownOneBits);
     uint64_t NumConcreteValues = pow(2, NumUnknownBits);
     ConcreteValues.clear();
+    VERIFY_STAT(ConcretizeCalls, 1);
+    VERIFY_STAT(SetInsertions, NumConcreteValues);
 
     // Positions of unknown bits
     std::vector<unsigned> UnknownBitPositions;
@@ -87,6 +867,17 @@ void concretize(const KnownBits &KBInstance, std::set<APInt, APIntComparator> &C
     }
 }
 
+// Function to format a KnownBits value most significant bit first, with 0 and 1
+// for known bits, ? for unknown ones and ! for conflicting ones
+std::string formatKnownBits(const KnownBits &KBInstance) {
+    std::string Text;
+    for (unsigned Bit = KBInstance.getBitWidth(); Bit-- > 0;) {
+        bool Zero = KBInstance.Zero[Bit], One = KBInstance.One[Bit];
+        Text += Zero && One ? '!' : Zero ? '0' : One ? '1' : '?';
+    }
+    return Text;
+}
+
 // Function to abstract a set of APInt values to a KnownBits value
 KnownBits abstract(const std::set<APInt, APIntComparator> &Values, unsigned BitWidth) {
     KnownBits KBInstance(BitWidth);
@@ -108,34 +899,50 @@ KnownBits abstract(const std::set<APInt, APIntComparator> &Values, unsigned BitW
 }
 
 
+// The unary transfer functions write into a caller-provided Result of the input's
+// bitwidth rather than returning a new KnownBits. APInt assignment and the in-place
+// shifts reuse the existing words, so a caller that keeps Result between inputs
+// does no allocation even above 64 bits, where every APInt lives on the heap.
+// Result must not alias the input.
+typedef void (*UnaryTransferIntoFn)(const KnownBits &KBInstance, unsigned Param, KnownBits &Result);
+
+// Function to run an in-place unary transfer function on a freshly allocated result
+inline KnownBits callWithNewResult(UnaryTransferIntoFn Fn, const KnownBits &KBInstance, unsigned Param) {
+    KnownBits Result(KBInstance.getBitWidth());
+    Fn(KBInstance, Param, Result);
+    return Result;
+}
+
 // Composite transfer function for sextInReg from LLVM KnownBits class
-KnownBits sextInRegComposite(const KnownBits &KBInstance, unsigned SrcBitWidth) {
+void sextInRegComposite(const KnownBits &KBInstance, unsigned SrcBitWidth, KnownBits &Result) {
     unsigned BitWidth = KBInstance.getBitWidth();
     assert(0 < SrcBitWidth && SrcBitWidth <= BitWidth && "Illegal sext-in-register");
 
+    Result = KBInstance;
     if (SrcBitWidth == BitWidth)
-        return KBInstance;
-    
+        return;
+
     unsigned ExtBits = BitWidth - SrcBitWidth;
-    KnownBits Result;
-    Result.One = KBInstance.One << ExtBits;
-    Result.Zero = KBInstance.Zero << ExtBits;
+    Result.One <<= ExtBits;
+    Result.Zero <<= ExtBits;
     Result.One.ashrInPlace(ExtBits);
     Result.Zero.ashrInPlace(ExtBits);
-    return Result;
 }
 
 
 // Decomposed transfer function using simpler operations
-KnownBits sextInRegDecomposed(const KnownBits &KBInstance, unsigned SrcBitWidth) {
+void sextInRegDecomposed(const KnownBits &KBInstance, unsigned SrcBitWidth, KnownBits &Result) {
     unsigned BitWidth = KBInstance.getBitWidth();
     assert(0 < SrcBitWidth && SrcBitWidth <= BitWidth && "Illegal sext-in-register");
+    assert(Result.getBitWidth() == BitWidth && &Result != &KBInstance && "Invalid result");
 
-    if (SrcBitWidth == BitWidth)
-        return KBInstance;
+    if (SrcBitWidth == BitWidth) {
+        Result = KBInstance;
+        return;
+    }
 
-    unsigned ExtBits = BitWidth - SrcBitWidth;
-    KnownBits Result(BitWidth);
+    Result.Zero.clearAllBits();
+    Result.One.clearAllBits();
 
     // Copy the original known bits into the lower SrcBitWidth bits
     for (unsigned i = 0; i < SrcBitWidth; ++i) {
@@ -162,68 +969,3964 @@ KnownBits sextInRegDecomposed(const KnownBits &KBInstance, unsigned SrcBitWidth)
             break;
         }
     }
+}
 
-    return Result;
+
+// Composite transfer function for zextInReg, the truncation to SrcBitWidth bits
+// followed by a zero extension back to the original width. LLVM's
+// trunc(SrcBitWidth).zext(BitWidth) allocates two temporaries, so the high bits
+// are shifted out and back in place instead, which gives the same masks.
+void zextInRegComposite(const KnownBits &KBInstance, unsigned SrcBitWidth, KnownBits &Result) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    assert(0 < SrcBitWidth && SrcBitWidth <= BitWidth && "Illegal zext-in-register");
+    unsigned ExtBits = BitWidth - SrcBitWidth;
+    Result = KBInstance;
+    Result.One <<= ExtBits;
+    Result.Zero <<= ExtBits;
+    Result.One.lshrInPlace(ExtBits);
+    Result.Zero.lshrInPlace(ExtBits);
+    Result.Zero.setHighBits(ExtBits);
 }
 
+// Decomposed transfer function for zextInReg
+void zextInRegDecomposed(const KnownBits &KBInstance, unsigned SrcBitWidth, KnownBits &Result) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    assert(0 < SrcBitWidth && SrcBitWidth <= BitWidth && "Illegal zext-in-register");
+    assert(Result.getBitWidth() == BitWidth && &Result != &KBInstance && "Invalid result");
+    Result.Zero.clearAllBits();
+    Result.One.clearAllBits();
 
-// Function to compare the composite and decomposed transfer functions
-void testTransferFunctions(unsigned BitWidth, unsigned SrcBitWidth) {
-    std::vector<KnownBits> KnownBitsList;
-    enumerateKnownBits(BitWidth, KnownBitsList);
+    // Copy the original known bits into the lower SrcBitWidth bits
+    for (unsigned i = 0; i < SrcBitWidth; ++i) {
+        if (KBInstance.One[i])
+            Result.One.setBit(i);
+        if (KBInstance.Zero[i])
+            Result.Zero.setBit(i);
+    }
 
-    uint64_t TotalComparisons = 0;
-    uint64_t CompositeMorePrecise = 0;
-    uint64_t DecomposedMorePrecise = 0;
-    uint64_t EquallyPrecise = 0;    // Added counter for equally precise cases
-    uint64_t Incomparable = 0;
+    // The higher bits are known zero
+    for (unsigned i = SrcBitWidth; i < BitWidth; ++i)
+        Result.Zero.setBit(i);
+}
 
-    for (const auto &KBInstance : KnownBitsList) {
-        TotalComparisons++;
+// Composite transfer function for shl by a constant from LLVM KnownBits class
+void shlComposite(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    assert(ShiftAmt < KBInstance.getBitWidth() && "Illegal shift amount");
+    Result = KBInstance;
+    Result.Zero <<= ShiftAmt;
+    Result.One <<= ShiftAmt;
+    // Low bits are known zero
+    Result.Zero.setLowBits(ShiftAmt);
+}
 
-        KnownBits CompositeResult = sextInRegComposite(KBInstance, SrcBitWidth);
-        KnownBits DecomposedResult = sextInRegDecomposed(KBInstance, SrcBitWidth);
+// Decomposed transfer function for shl, moving one bit at a time
+void shlDecomposed(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    assert(ShiftAmt < BitWidth && "Illegal shift amount");
+    assert(Result.getBitWidth() == BitWidth && &Result != &KBInstance && "Invalid result");
+    Result.Zero.clearAllBits();
+    Result.One.clearAllBits();
 
-        // Check which result is more precise
-        std::set<APInt, APIntComparator> CompositeConcrete, DecomposedConcrete;
-        concretize(CompositeResult, CompositeConcrete);
-        concretize(DecomposedResult, DecomposedConcrete);
-
-        bool CompositeSubset = std::includes(DecomposedConcrete.begin(), DecomposedConcrete.end(),
-                                             CompositeConcrete.begin(), CompositeConcrete.end(), APIntComparator());
-
-        bool DecomposedSubset = std::includes(CompositeConcrete.begin(), CompositeConcrete.end(),
-                                              DecomposedConcrete.begin(), DecomposedConcrete.end(), APIntComparator());
-
-        if (CompositeConcrete == DecomposedConcrete) {
-            EquallyPrecise++;
-        } else if (CompositeSubset && !DecomposedSubset) {
-            CompositeMorePrecise++;
-        } else if (DecomposedSubset && !CompositeSubset) {
-            DecomposedMorePrecise++;
-        } else {
-            Incomparable++;
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        if (i < ShiftAmt) {
+            // Bits shifted in are zero
+            Result.Zero.setBit(i);
+            continue;
+        }
+        if (KBInstance.One[i - ShiftAmt])
+            Result.One.setBit(i);
+        if (KBInstance.Zero[i - ShiftAmt])
+            Result.Zero.setBit(i);
+    }
+}
+
+// Composite transfer function for lshr by a constant from LLVM KnownBits class
+void lshrComposite(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    assert(ShiftAmt < KBInstance.getBitWidth() && "Illegal shift amount");
+    Result = KBInstance;
+    Result.Zero.lshrInPlace(ShiftAmt);
+    Result.One.lshrInPlace(ShiftAmt);
+    // High bits are known zero
+    Result.Zero.setHighBits(ShiftAmt);
+}
+
+// Decomposed transfer function for lshr, moving one bit at a time
+void lshrDecomposed(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    assert(ShiftAmt < BitWidth && "Illegal shift amount");
+    assert(Result.getBitWidth() == BitWidth && &Result != &KBInstance && "Invalid result");
+    Result.Zero.clearAllBits();
+    Result.One.clearAllBits();
+
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        if (i + ShiftAmt >= BitWidth) {
+            // Bits shifted in are zero
+            Result.Zero.setBit(i);
+            continue;
         }
+        if (KBInstance.One[i + ShiftAmt])
+            Result.One.setBit(i);
+        if (KBInstance.Zero[i + ShiftAmt])
+            Result.Zero.setBit(i);
+    }
+}
+
+// Composite transfer function for ashr by a constant from LLVM KnownBits class
+void ashrComposite(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    assert(ShiftAmt < KBInstance.getBitWidth() && "Illegal shift amount");
+    Result = KBInstance;
+    Result.Zero.ashrInPlace(ShiftAmt);
+    Result.One.ashrInPlace(ShiftAmt);
+}
+
+// Decomposed transfer function for ashr, moving one bit at a time
+void ashrDecomposed(const KnownBits &KBInstance, unsigned ShiftAmt, KnownBits &Result) {
+    unsigned BitWidth = KBInstance.getBitWidth();
+    assert(ShiftAmt < BitWidth && "Illegal shift amount");
+    assert(Result.getBitWidth() == BitWidth && &Result != &KBInstance && "Invalid result");
+    Result.Zero.clearAllBits();
+    Result.One.clearAllBits();
+
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        // Bits shifted in are copies of the sign bit
+        unsigned SrcBit = std::min(i + ShiftAmt, BitWidth - 1);
+        if (KBInstance.One[SrcBit])
+            Result.One.setBit(i);
+        if (KBInstance.Zero[SrcBit])
+            Result.Zero.setBit(i);
+    }
+}
+
+
+// Composite transfer function for the bitwise and from LLVM KnownBits class
+KnownBits andComposite(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result = LHS;
+    Result &= RHS;
+    return Result;
+}
+
+// Composite transfer function for the bitwise or from LLVM KnownBits class
+KnownBits orComposite(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result = LHS;
+    Result |= RHS;
+    return Result;
+}
+
+// Composite transfer function for the bitwise xor from LLVM KnownBits class
+KnownBits xorComposite(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result = LHS;
+    Result ^= RHS;
+    return Result;
+}
+
+// Three-valued bit used by the decomposed binary transfer functions
+enum class Trit { Zero, One, Unknown };
+
+Trit getTrit(const KnownBits &KBInstance, unsigned Bit) {
+    if (KBInstance.Zero[Bit])
+        return Trit::Zero;
+    if (KBInstance.One[Bit])
+        return Trit::One;
+    return Trit::Unknown;
+}
+
+void setTrit(KnownBits &KBInstance, unsigned Bit, Trit Value) {
+    if (Value == Trit::Zero)
+        KBInstance.Zero.setBit(Bit);
+    else if (Value == Trit::One)
+        KBInstance.One.setBit(Bit);
+}
+
+Trit andTrit(Trit A, Trit B) {
+    if (A == Trit::Zero || B == Trit::Zero)
+        return Trit::Zero;
+    if (A == Trit::One && B == Trit::One)
+        return Trit::One;
+    return Trit::Unknown;
+}
+
+Trit orTrit(Trit A, Trit B) {
+    if (A == Trit::One || B == Trit::One)
+        return Trit::One;
+    if (A == Trit::Zero && B == Trit::Zero)
+        return Trit::Zero;
+    return Trit::Unknown;
+}
+
+Trit xorTrit(Trit A, Trit B) {
+    if (A == Trit::Unknown || B == Trit::Unknown)
+        return Trit::Unknown;
+    return A == B ? Trit::Zero : Trit::One;
+}
+
+Trit notTrit(Trit A) {
+    if (A == Trit::Unknown)
+        return Trit::Unknown;
+    return A == Trit::Zero ? Trit::One : Trit::Zero;
+}
+
+// Carry out of a full adder: known whenever two of the inputs agree on a known value
+Trit majorityTrit(Trit A, Trit B, Trit C) {
+    unsigned NumOnes = (A == Trit::One) + (B == Trit::One) + (C == Trit::One);
+    unsigned NumZeros = (A == Trit::Zero) + (B == Trit::Zero) + (C == Trit::Zero);
+    if (NumOnes >= 2)
+        return Trit::One;
+    if (NumZeros >= 2)
+        return Trit::Zero;
+    return Trit::Unknown;
+}
+
+// Decomposed transfer function for the bitwise and, one bit at a time
+KnownBits andDecomposed(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result(LHS.getBitWidth());
+    for (unsigned i = 0; i < LHS.getBitWidth(); ++i)
+        setTrit(Result, i, andTrit(getTrit(LHS, i), getTrit(RHS, i)));
+    return Result;
+}
+
+// Decomposed transfer function for the bitwise or, one bit at a time
+KnownBits orDecomposed(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result(LHS.getBitWidth());
+    for (unsigned i = 0; i < LHS.getBitWidth(); ++i)
+        setTrit(Result, i, orTrit(getTrit(LHS, i), getTrit(RHS, i)));
+    return Result;
+}
+
+// Decomposed transfer function for the bitwise xor, one bit at a time
+KnownBits xorDecomposed(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result(LHS.getBitWidth());
+    for (unsigned i = 0; i < LHS.getBitWidth(); ++i)
+        setTrit(Result, i, xorTrit(getTrit(LHS, i), getTrit(RHS, i)));
+    return Result;
+}
+
+// Sum of two values and a carry as computed by KnownBits::computeForAddCarry in LLVM
+KnownBits addCarryComposite(const KnownBits &LHS, const KnownBits &RHS, bool CarryZero, bool CarryOne) {
+    assert(!(CarryZero && CarryOne) && "Carry can't be zero and one at the same time");
+
+    APInt PossibleSumZero = LHS.getMaxValue() + RHS.getMaxValue() + !CarryZero;
+    APInt PossibleSumOne = LHS.One + RHS.One + CarryOne;
+
+    // Compute known bits of the carry
+    APInt CarryKnownZero = ~(PossibleSumZero ^ LHS.Zero ^ RHS.Zero);
+    APInt CarryKnownOne = PossibleSumOne ^ LHS.One ^ RHS.One;
+
+    // Compute set of known bits (where all three relevant bits are known)
+    APInt LHSKnownUnion = LHS.Zero | LHS.One;
+    APInt RHSKnownUnion = RHS.Zero | RHS.One;
+    APInt CarryKnownUnion = CarryKnownZero | CarryKnownOne;
+    APInt Known = LHSKnownUnion & RHSKnownUnion & CarryKnownUnion;
+
+    KnownBits Result(LHS.getBitWidth());
+    Result.Zero = ~PossibleSumZero & Known;
+    Result.One = PossibleSumOne & Known;
+    return Result;
+}
+
+// Composite transfer function for add from LLVM KnownBits class
+KnownBits addComposite(const KnownBits &LHS, const KnownBits &RHS) {
+    return addCarryComposite(LHS, RHS, /*CarryZero=*/true, /*CarryOne=*/false);
+}
+
+// Composite transfer function for sub from LLVM KnownBits class: LHS + ~RHS + 1
+KnownBits subComposite(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits NotRHS(RHS.getBitWidth());
+    NotRHS.Zero = RHS.One;
+    NotRHS.One = RHS.Zero;
+    return addCarryComposite(LHS, NotRHS, /*CarryZero=*/false, /*CarryOne=*/true);
+}
+
+// Decomposed transfer function for add as a ripple-carry adder over three-valued bits
+KnownBits addDecomposed(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result(LHS.getBitWidth());
+    Trit Carry = Trit::Zero;
+    for (unsigned i = 0; i < LHS.getBitWidth(); ++i) {
+        Trit A = getTrit(LHS, i), B = getTrit(RHS, i);
+        setTrit(Result, i, xorTrit(xorTrit(A, B), Carry));
+        Carry = majorityTrit(A, B, Carry);
+    }
+    return Result;
+}
+
+// Decomposed transfer function for sub as a ripple-carry adder of LHS, ~RHS and 1
+KnownBits subDecomposed(const KnownBits &LHS, const KnownBits &RHS) {
+    KnownBits Result(LHS.getBitWidth());
+    Trit Carry = Trit::One;
+    for (unsigned i = 0; i < LHS.getBitWidth(); ++i) {
+        Trit A = getTrit(LHS, i), B = notTrit(getTrit(RHS, i));
+        setTrit(Result, i, xorTrit(xorTrit(A, B), Carry));
+        Carry = majorityTrit(A, B, Carry);
     }
+    return Result;
+}
+
 
-    std::cout << "BitWidth: " << BitWidth << ", SrcBitWidth: " << SrcBitWidth << "\n";
-    std::cout << "Total Values: " << TotalComparisons << "\n";
-    std::cout << "Equal Precision: " << EquallyPrecise << "\n";
-    std::cout << "Composite More Precise: " << CompositeMorePrecise << "\n";
-    std::cout << "Decomposed More Precise: " << DecomposedMorePrecise << "\n";
-    std::cout << "Incomparable Results: " << Incomparable << "\n\n";
+// Function to get the precision distance of two results, the known bits of B
+// minus those of A. Both must be conflict free, so each mask's popcount counts
+// distinct bits.
+inline int getPrecisionDistance(const KnownBits &A, const KnownBits &B) {
+    return int(B.Zero.countPopulation() + B.One.countPopulation()) -
+           int(A.Zero.countPopulation() + A.One.countPopulation());
 }
 
-// Function to run tests for bit widths from 4 to 8
-void runTests() {
-    for (unsigned BitWidth = 4; BitWidth <= 8; ++BitWidth) {
-        for (unsigned SrcBitWidth = 1; SrcBitWidth <= BitWidth; ++SrcBitWidth) {
-            testTransferFunctions(BitWidth, SrcBitWidth);
+// Function to compare two KnownBits values directly in the lattice order.
+// concretize(A) is a subset of concretize(B) exactly when every bit known in B
+// is also known, with the same value, in A. Both values must be conflict free.
+PrecisionOrder comparePrecision(const KnownBits &A, const KnownBits &B) {
+    assert(!A.hasConflict() && !B.hasConflict() && "Conflicting KnownBits");
+    bool AInB = B.Zero.isSubsetOf(A.Zero) && B.One.isSubsetOf(A.One);
+    bool BInA = A.Zero.isSubsetOf(B.Zero) && A.One.isSubsetOf(B.One);
+
+    if (AInB && BInA)
+        return PrecisionOrder::Equal;
+    if (AInB)
+        return PrecisionOrder::FirstMorePrecise;
+    if (BInA)
+        return PrecisionOrder::SecondMorePrecise;
+    return PrecisionOrder::Incomparable;
+}
+
+// Concretization of a KnownBits value as a dense bitset with one bit per concrete
+// value, for bitwidths up to MaxBitsetConcretizationBitWidth. Subset tests and
+// equality are word-wise, and the words are kept between assignments, so refilling
+// a set of the same bitwidth does not allocate.
+class ConcreteValueSet {
+public:
+    // Function to replace the contents with the concretization of KBInstance
+    void assign(const KnownBits &KBInstance) {
+        unsigned BitWidth = KBInstance.getBitWidth();
+        assert(BitWidth <= MaxBitsetConcretizationBitWidth && "Bitwidth too large for a bitset");
+        Words.assign(BitWidth < 6 ? 1 : uint64_t(1) << (BitWidth - 6), 0);
+        uint64_t One = KBInstance.One.getZExtValue();
+        uint64_t Unknown = ~(KBInstance.Zero.getZExtValue() | One) & maskTrailingOnes<uint64_t>(BitWidth);
+        VERIFY_STAT(BitsetConcretizations, 1);
+        VERIFY_STAT(BitsetInsertions, uint64_t(1) << countPopulation(Unknown));
+        // Walk every subset of the unknown bits
+        uint64_t Subset = 0;
+        do {
+            uint64_t Value = One | Subset;
+            Words[Value / 64] |= uint64_t(1) << (Value % 64);
+            Subset = (Subset - Unknown) & Unknown;
+        } while (Subset != 0);
+    }
+
+    // Replacement for std::includes: true if every value of Other is in this set
+    bool includes(const ConcreteValueSet &Other) const {
+        assert(Words.size() == Other.Words.size() && "Sets of different bitwidths");
+        for (size_t i = 0; i < Words.size(); ++i) {
+            if (Other.Words[i] & ~Words[i])
+                return false;
         }
+        return true;
+    }
+
+    bool operator==(const ConcreteValueSet &Other) const { return Words == Other.Words; }
+
+private:
+    std::vector<uint64_t> Words;
+};
+
+// Function to compare two KnownBits values through their concretizations.
+// This is much slower than comparePrecision and is only used as a cross-check.
+PrecisionOrder comparePrecisionByConcretization(const KnownBits &A, const KnownBits &B) {
+    if (A.getBitWidth() <= MaxBitsetConcretizationBitWidth) {
+        // One pair of sets per thread, reused by every comparison it makes
+        static thread_local ConcreteValueSet AConcrete, BConcrete;
+        AConcrete.assign(A);
+        BConcrete.assign(B);
+        if (AConcrete == BConcrete)
+            return PrecisionOrder::Equal;
+        if (BConcrete.includes(AConcrete))
+            return PrecisionOrder::FirstMorePrecise;
+        if (AConcrete.includes(BConcrete))
+            return PrecisionOrder::SecondMorePrecise;
+        return PrecisionOrder::Incomparable;
     }
+
+    std::set<APInt, APIntComparator> AConcrete, BConcrete;
+    concretize(A, AConcrete);
+    concretize(B, BConcrete);
+
+    bool ASubset = std::includes(BConcrete.begin(), BConcrete.end(),
+                                 AConcrete.begin(), AConcrete.end(), APIntComparator());
+
+    bool BSubset = std::includes(AConcrete.begin(), AConcrete.end(),
+                                 BConcrete.begin(), BConcrete.end(), APIntComparator());
+
+    if (AConcrete == BConcrete)
+        return PrecisionOrder::Equal;
+    if (ASubset && !BSubset)
+        return PrecisionOrder::FirstMorePrecise;
+    if (BSubset && !ASubset)
+        return PrecisionOrder::SecondMorePrecise;
+    return PrecisionOrder::Incomparable;
 }
 
-int main() {
-    runTests();
-    return 0;
+// The batched backend works on blocks of abstract values whose base-3 indices share
+// all but the low BatchDigits digits. Those digits take every one of their
+// BatchSize values within an aligned block, so the inputs of a block are a single
+// decoded high part combined with a precomputed low part, without a serial
+// increment between lanes.
+static const unsigned BatchDigits = 5;
+static const unsigned BatchSize = 243; // 3^BatchDigits
+
+// Number of abstract values handed to a worker at a time, a whole number of blocks
+static const uint64_t SweepChunkSize = 16 * BatchSize;
+
+// Counters for the outcomes of comparing the composite and decomposed results
+struct PrecisionCounts {
+    uint64_t TotalComparisons = 0;
+    uint64_t CompositeMorePrecise = 0;
+    uint64_t DecomposedMorePrecise = 0;
+    uint64_t EquallyPrecise = 0;
+    uint64_t Incomparable = 0;
+    uint64_t CrossCheckMismatches = 0;
+    uint64_t BackendMismatches = 0;
+    uint64_t StoreMismatches = 0;
+    uint64_t LibraryMismatches = 0; // Composite results that differ from the linked LLVM's (--llvm)
+
+    // Outcomes of comparing each function against the optimal transformer
+    // (--optimal). The unsound counters are also filled by --soundness.
+    uint64_t CompositeOptimal = 0;
+    uint64_t CompositeSuboptimal = 0;
+    uint64_t CompositeUnsound = 0;
+    uint64_t DecomposedOptimal = 0;
+    uint64_t DecomposedSuboptimal = 0;
+    uint64_t DecomposedUnsound = 0;
+
+    // Histogram of the precision distance (--distance): the known bits of the
+    // decomposed result minus those of the composite one, which is log2 of how
+    // many times larger the composite concretization is. Bin
+    // MaxExhaustiveBitWidth holds distance 0.
+    uint64_t DistanceBins[2 * MaxExhaustiveBitWidth + 1] = {};
+
+    // Orders are those of the composite and decomposed results with respect to the
+    // optimal result. A result can only be unsound if it claims more than the optimal one.
+    void recordOptimality(PrecisionOrder CompositeOrder, PrecisionOrder DecomposedOrder, uint64_t Weight = 1) {
+        recordOptimality(CompositeOrder, CompositeOptimal, CompositeSuboptimal, CompositeUnsound, Weight);
+        recordOptimality(DecomposedOrder, DecomposedOptimal, DecomposedSuboptimal, DecomposedUnsound, Weight);
+    }
+
+    void recordSoundness(bool CompositeSound, bool DecomposedSound, uint64_t Weight = 1) {
+        CompositeUnsound += CompositeSound ? 0 : Weight;
+        DecomposedUnsound += DecomposedSound ? 0 : Weight;
+    }
+
+    void recordDistance(int Distance, uint64_t Weight = 1) {
+        DistanceBins[Distance + int(MaxExhaustiveBitWidth)] += Weight;
+    }
+
+    void record(PrecisionOrder Order, uint64_t Weight = 1) {
+        TotalComparisons += Weight;
+        switch (Order) {
+        case PrecisionOrder::Equal:
+            EquallyPrecise += Weight;
+            break;
+        case PrecisionOrder::FirstMorePrecise:
+            CompositeMorePrecise += Weight;
+            break;
+        case PrecisionOrder::SecondMorePrecise:
+            DecomposedMorePrecise += Weight;
+            break;
+        case PrecisionOrder::Incomparable:
+            Incomparable += Weight;
+            break;
+        }
+    }
+
+    // Function to multiply every counter by Weight, for inputs that each stand
+    // for Weight inputs
+    void scale(uint64_t Weight) {
+        forEachCounter([Weight](uint64_t &Counter) { Counter *= Weight; });
+        for (uint64_t &Bin : DistanceBins)
+            Bin *= Weight;
+    }
+
+    // Function to call Callback on every counter, in a fixed order. The distance
+    // histogram is not included.
+    template <typename CallbackFn>
+    void forEachCounter(CallbackFn Callback) {
+        for (uint64_t *Counter : {&TotalComparisons, &CompositeMorePrecise, &DecomposedMorePrecise,
+                                  &EquallyPrecise, &Incomparable, &CrossCheckMismatches, &BackendMismatches,
+                                  &CompositeOptimal, &CompositeSuboptimal, &CompositeUnsound,
+                                  &DecomposedOptimal, &DecomposedSuboptimal, &DecomposedUnsound,
+                                  &StoreMismatches, &LibraryMismatches})
+            Callback(*Counter);
+    }
+
+    PrecisionCounts &operator+=(const PrecisionCounts &Other) {
+        TotalComparisons += Other.TotalComparisons;
+        CompositeMorePrecise += Other.CompositeMorePrecise;
+        DecomposedMorePrecise += Other.DecomposedMorePrecise;
+        EquallyPrecise += Other.EquallyPrecise;
+        Incomparable += Other.Incomparable;
+        CrossCheckMismatches += Other.CrossCheckMismatches;
+        BackendMismatches += Other.BackendMismatches;
+        CompositeOptimal += Other.CompositeOptimal;
+        CompositeSuboptimal += Other.CompositeSuboptimal;
+        CompositeUnsound += Other.CompositeUnsound;
+        DecomposedOptimal += Other.DecomposedOptimal;
+        DecomposedSuboptimal += Other.DecomposedSuboptimal;
+        DecomposedUnsound += Other.DecomposedUnsound;
+        StoreMismatches += Other.StoreMismatches;
+        LibraryMismatches += Other.LibraryMismatches;
+        for (unsigned Bin = 0; Bin < array_lengthof(DistanceBins); ++Bin)
+            DistanceBins[Bin] += Other.DistanceBins[Bin];
+        return *this;
+    }
+
+private:
+    static void recordOptimality(PrecisionOrder Order, uint64_t &Optimal, uint64_t &Suboptimal,
+                                 uint64_t &Unsound, uint64_t Weight) {
+        if (Order == PrecisionOrder::Equal)
+            Optimal += Weight;
+        else if (Order == PrecisionOrder::SecondMorePrecise)
+            Suboptimal += Weight;
+        else
+            Unsound += Weight;
+    }
+};
+
+// Per-configuration data shared by every worker of a sweep
+struct SweepContext {
+    unsigned Param = 0;                         // Parameter passed to the transfer functions
+    const uint64_t *ConcreteResults = nullptr;  // Table of concrete results, see buildConcreteTable
+    const uint64_t *OptimalZero = nullptr;      // Optimal results by abstract value index, see
+    const uint64_t *OptimalOne = nullptr;       // buildOptimalTable, null if not tabulated
+    uint8_t *Orders = nullptr;                  // Packed orders by abstract value index (--store,
+                                                // --diff), see storePrecisionOrder, null if not kept
+};
+
+// Orders are packed four to a byte, the lowest index in the low bits. Chunks
+// start at multiples of four, so workers never share a byte.
+static_assert(SweepChunkSize % 4 == 0, "Sweep chunks must not split a byte of packed orders");
+
+// Function to record the order of the input with the given index
+inline void storePrecisionOrder(uint8_t *Orders, uint64_t Index, PrecisionOrder Order) {
+    Orders[Index / 4] |= uint8_t(unsigned(Order) << (2 * (Index % 4)));
+}
+
+// Function to run Body(Worker, Begin, End) over [0, NumItems) in chunks of ChunkSize.
+// Each pool thread runs one worker that keeps pulling chunks until the range is
+// exhausted, so Worker can index per-thread state without synchronization.
+template <typename BodyFn>
+void parallelForChunks(ThreadPool &Pool, uint64_t NumItems, uint64_t ChunkSize, BodyFn Body) {
+    std::atomic<uint64_t> NextChunk(0);
+    unsigned NumWorkers = Pool.getThreadCount();
+#ifdef VERIFY_STATS
+    // A worker is busy while it runs Body, and idle for the rest of the call
+    std::chrono::steady_clock::time_point RegionStart = std::chrono::steady_clock::now();
+    std::vector<uint64_t> BusyNanos(NumWorkers);
+#endif
+    for (unsigned Worker = 0; Worker < NumWorkers; ++Worker) {
+        Pool.async([&, Worker] {
+            for (;;) {
+                uint64_t Begin = NextChunk.fetch_add(ChunkSize);
+                if (Begin >= NumItems)
+                    break;
+#ifdef VERIFY_STATS
+                std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+                Body(Worker, Begin, std::min(NumItems, Begin + ChunkSize));
+                BusyNanos[Worker] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - Start).count();
+#else
+                Body(Worker, Begin, std::min(NumItems, Begin + ChunkSize));
+#endif
+            }
+        });
+    }
+    Pool.wait();
+#ifdef VERIFY_STATS
+    uint64_t RegionNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - RegionStart).count();
+    VERIFY_STAT(ParallelRegions, 1);
+    for (unsigned Worker = 0; Worker < NumWorkers; ++Worker) {
+        unsigned Slot = std::min(Worker, MaxStatsWorkers - 1);
+        VERIFY_STAT(WorkerBusyNanos[Slot], BusyNanos[Worker]);
+        VERIFY_STAT(WorkerIdleNanos[Slot], RegionNanos - std::min(RegionNanos, BusyNanos[Worker]));
+    }
+#endif
+}
+
+// Function to convert KBInstance of N bits to the fixed-width representation
+template <unsigned N>
+KnownBitsFixed<N> toKnownBitsFixed(const KnownBits &KBInstance) {
+    assert(KBInstance.getBitWidth() == N && "Bitwidth mismatch");
+    KnownBitsFixed<N> Result;
+    Result.Zero = KBInstance.Zero.getZExtValue();
+    Result.One = KBInstance.One.getZExtValue();
+    return Result;
+}
+
+// Function to convert a fixed-width value back to llvm::KnownBits
+template <unsigned N>
+KnownBits toKnownBits(const KnownBitsFixed<N> &KBInstance) {
+    KnownBits Result(N);
+    Result.Zero = APInt(N, KBInstance.Zero);
+    Result.One = APInt(N, KBInstance.One);
+    return Result;
+}
+
+// Function to decode the base-3 index of an abstract value into fixed-width masks
+template <unsigned N>
+constexpr KnownBitsFixed<N> decodeKnownBitsFixed(uint64_t Index) {
+    KnownBitsFixed<N> Result;
+    decodeKnownBitsMasks(Index, N, Result.Zero, Result.One);
+    return Result;
+}
+
+// Function to advance fixed-width masks to the abstract value with the next base-3 index
+template <unsigned N>
+void incrementKnownBitsFixed(KnownBitsFixed<N> &KBInstance) {
+    incrementKnownBitsMasks(KBInstance.Zero, KBInstance.One, N);
+}
+
+// Function to get the signed difference in known-bit count of two fixed-width values, B minus A
+template <unsigned N>
+inline int getPrecisionDistance(const KnownBitsFixed<N> &A, const KnownBitsFixed<N> &B) {
+    return int(countPopulation(B.Zero | B.One)) - int(countPopulation(A.Zero | A.One));
+}
+
+// Transfer function pairs handled by the sweeps. Each operation bundles the
+// APInt and fixed-width versions of its composite and decomposed functions so
+// that the sweep templates below can be instantiated per operation and bitwidth,
+// together with the concrete operation they abstract.
+struct SextInRegOp {
+    // Bumped on every change to the functions below, see --incremental
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &Value, unsigned Param) { return Value.trunc(Param).sext(Value.getBitWidth()); }
+    // Only the low SrcBitWidth input bits reach the result
+    static std::pair<unsigned, unsigned> support(unsigned /*BitWidth*/, unsigned Param) { return {0, Param}; }
+    // Which result bits either function knows depends on which input bits are
+    // known, not on their values: the extension bits are known exactly when the
+    // sign bit is. See --group-by-mask.
+    static const bool MaskDetermined = true;
+    // Both functions compare equal on every input up to this bitwidth, for every
+    // SrcBitWidth. The fixed-width functions are constexpr and this is checked
+    // while compiling, see SextInRegStaticallyEqual and --skip-static.
+    static const unsigned StaticBitWidth = 6;
+    static KnownBits composite(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(sextInRegComposite, KBInstance, Param);
+    }
+    static void compositeInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        sextInRegComposite(KBInstance, Param, Result);
+    }
+    static KnownBits decomposed(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(sextInRegDecomposed, KBInstance, Param);
+    }
+    static void decomposedInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        sextInRegDecomposed(KBInstance, Param, Result);
+    }
+    // The linked LLVM's own KnownBits::sextInReg, run on a batch of inputs (see --llvm)
+    static void libraryBatch(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = Inputs[i].sextInReg(Param);
+    }
+    template <unsigned N>
+    static constexpr KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return sextInRegCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    static constexpr KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return sextInRegDecomposedFixed(KBInstance, Param);
+    }
+};
+
+// Function to check that the fixed-width functions of Op compare equal on every
+// abstract value of N bits, for every parameter in [MinParam, MaxParam]. It is
+// evaluated at compile time, so the functions of Op must be constexpr.
+template <typename Op, unsigned N>
+constexpr bool isEqualOnDomainFixed(unsigned MinParam, unsigned MaxParam) {
+    for (unsigned Param = MinParam; Param <= MaxParam; ++Param) {
+        for (uint64_t Index = 0; Index < numAbstractValues(N); ++Index) {
+            KnownBitsFixed<N> KBInstance = decodeKnownBitsFixed<N>(Index);
+            if (comparePrecisionFixed(Op::compositeFixed(KBInstance, Param), Op::decomposedFixed(KBInstance, Param)) !=
+                PrecisionOrder::Equal)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Every (BitWidth, SrcBitWidth) of sextInReg up to BitWidth N, 3^N * N inputs at N
+template <unsigned N>
+struct SextInRegStaticallyEqual {
+    static constexpr bool value = isEqualOnDomainFixed<SextInRegOp, N>(1, N) && SextInRegStaticallyEqual<N - 1>::value;
+};
+
+template <>
+struct SextInRegStaticallyEqual<0> {
+    static constexpr bool value = true;
+};
+
+static_assert(SextInRegStaticallyEqual<SextInRegOp::StaticBitWidth>::value,
+              "sextInReg composite and decomposed results differ at a bitwidth up to StaticBitWidth");
+
+struct ZextInRegOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &Value, unsigned Param) { return Value.trunc(Param).zext(Value.getBitWidth()); }
+    static std::pair<unsigned, unsigned> support(unsigned /*BitWidth*/, unsigned Param) { return {0, Param}; }
+    static const bool MaskDetermined = true;
+    static const unsigned StaticBitWidth = 0;
+    static KnownBits composite(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(zextInRegComposite, KBInstance, Param);
+    }
+    static void compositeInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        zextInRegComposite(KBInstance, Param, Result);
+    }
+    static KnownBits decomposed(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(zextInRegDecomposed, KBInstance, Param);
+    }
+    static void decomposedInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        zextInRegDecomposed(KBInstance, Param, Result);
+    }
+    // KnownBits::trunc and KnownBits::zext of the linked LLVM
+    static void libraryBatch(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = Inputs[i].trunc(Param).zext(Inputs[i].getBitWidth());
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return zextInRegCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return zextInRegDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct ShlOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &Value, unsigned Param) { return Value.shl(Param); }
+    // The high ShiftAmt input bits are shifted out
+    static std::pair<unsigned, unsigned> support(unsigned BitWidth, unsigned Param) { return {0, BitWidth - Param}; }
+    static const bool MaskDetermined = true;
+    static const unsigned StaticBitWidth = 0;
+    static KnownBits composite(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(shlComposite, KBInstance, Param);
+    }
+    static void compositeInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        shlComposite(KBInstance, Param, Result);
+    }
+    static KnownBits decomposed(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(shlDecomposed, KBInstance, Param);
+    }
+    static void decomposedInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        shlDecomposed(KBInstance, Param, Result);
+    }
+    // KnownBits::shl of the linked LLVM
+    static void libraryBatch(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results) {
+        assert(NumInputs > 0 && "Empty batch");
+        // The shift amount is a constant, built once per batch
+        KnownBits Amount = KnownBits::makeConstant(APInt(Inputs[0].getBitWidth(), Param));
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = KnownBits::shl(Inputs[i], Amount);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return shlCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return shlDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct LshrOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &Value, unsigned Param) { return Value.lshr(Param); }
+    // The low ShiftAmt input bits are shifted out
+    static std::pair<unsigned, unsigned> support(unsigned BitWidth, unsigned Param) { return {Param, BitWidth}; }
+    static const bool MaskDetermined = true;
+    static const unsigned StaticBitWidth = 0;
+    static KnownBits composite(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(lshrComposite, KBInstance, Param);
+    }
+    static void compositeInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        lshrComposite(KBInstance, Param, Result);
+    }
+    static KnownBits decomposed(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(lshrDecomposed, KBInstance, Param);
+    }
+    static void decomposedInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        lshrDecomposed(KBInstance, Param, Result);
+    }
+    // KnownBits::lshr of the linked LLVM
+    static void libraryBatch(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results) {
+        assert(NumInputs > 0 && "Empty batch");
+        KnownBits Amount = KnownBits::makeConstant(APInt(Inputs[0].getBitWidth(), Param));
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = KnownBits::lshr(Inputs[i], Amount);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return lshrCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return lshrDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct AshrOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &Value, unsigned Param) { return Value.ashr(Param); }
+    static std::pair<unsigned, unsigned> support(unsigned BitWidth, unsigned Param) { return {Param, BitWidth}; }
+    static const bool MaskDetermined = true;
+    static const unsigned StaticBitWidth = 0;
+    static KnownBits composite(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(ashrComposite, KBInstance, Param);
+    }
+    static void compositeInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        ashrComposite(KBInstance, Param, Result);
+    }
+    static KnownBits decomposed(const KnownBits &KBInstance, unsigned Param) {
+        return callWithNewResult(ashrDecomposed, KBInstance, Param);
+    }
+    static void decomposedInto(const KnownBits &KBInstance, unsigned Param, KnownBits &Result) {
+        ashrDecomposed(KBInstance, Param, Result);
+    }
+    // KnownBits::ashr of the linked LLVM
+    static void libraryBatch(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results) {
+        assert(NumInputs > 0 && "Empty batch");
+        KnownBits Amount = KnownBits::makeConstant(APInt(Inputs[0].getBitWidth(), Param));
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = KnownBits::ashr(Inputs[i], Amount);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return ashrCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return ashrDecomposedFixed(KBInstance, Param);
+    }
+};
+
+// Function to compute the optimal transformer abstract(f(concretize(x))) of an
+// input with the given masks over BitWidth bits. Every concrete value of the
+// input is looked up in ConcreteResults, which holds f for every value of the
+// input bits, and the results are abstracted by intersecting their bits. Results
+// are masked to BitWidth, so callers with narrower results mask them further.
+void optimalFromTable(uint64_t Zero, uint64_t One, unsigned BitWidth, const uint64_t *ConcreteResults,
+                      uint64_t &OptimalZero, uint64_t &OptimalOne) {
+    uint64_t Mask = maskTrailingOnes<uint64_t>(BitWidth);
+    uint64_t Unknown = ~(Zero | One) & Mask;
+    uint64_t KnownZero = Mask, KnownOne = Mask;
+    // Walk every subset of the unknown bits
+    uint64_t Subset = 0;
+    do {
+        uint64_t Result = ConcreteResults[One | Subset];
+        KnownZero &= ~Result;
+        KnownOne &= Result;
+        Subset = (Subset - Unknown) & Unknown;
+    } while (Subset != 0);
+    OptimalZero = KnownZero;
+    OptimalOne = KnownOne;
+}
+
+// Function to check that the composite and decomposed results, given by their
+// masks, admit f(v) for every concrete value v of the input with masks Zero/One
+// over BitWidth bits, with f looked up in ConcreteResults as in optimalFromTable.
+// Each value costs two mask tests per result rather than a set lookup, and the
+// walk stops once both results are known to be unsound.
+template <typename ResultT>
+void checkSoundnessFromTable(uint64_t Zero, uint64_t One, unsigned BitWidth, const uint64_t *ConcreteResults,
+                             const ResultT &Composite, const ResultT &Decomposed, bool &CompositeSound,
+                             bool &DecomposedSound) {
+    uint64_t Unknown = ~(Zero | One) & maskTrailingOnes<uint64_t>(BitWidth);
+    uint64_t CompositeMissed = 0, DecomposedMissed = 0;
+    uint64_t Subset = 0;
+    do {
+        uint64_t Result = ConcreteResults[One | Subset];
+        CompositeMissed |= (Result & Composite.Zero) | (~Result & Composite.One);
+        DecomposedMissed |= (Result & Decomposed.Zero) | (~Result & Decomposed.One);
+        Subset = (Subset - Unknown) & Unknown;
+    } while (Subset != 0 && (CompositeMissed == 0 || DecomposedMissed == 0));
+    CompositeSound = CompositeMissed == 0;
+    DecomposedSound = DecomposedMissed == 0;
+}
+
+// Function to check both results of the unary input with the given index and
+// masks for soundness. With an optimal table, a result admits every concrete
+// outcome exactly when it knows no bit that the optimal result does not, which
+// is one mask test per result; otherwise the concrete values are walked.
+template <typename ResultT>
+void checkSoundness(const SweepContext &Context, uint64_t Index, uint64_t Zero, uint64_t One, unsigned BitWidth,
+                    const ResultT &Composite, const ResultT &Decomposed, bool &CompositeSound,
+                    bool &DecomposedSound) {
+    if (!Context.OptimalZero) {
+        checkSoundnessFromTable(Zero, One, BitWidth, Context.ConcreteResults, Composite, Decomposed,
+                                CompositeSound, DecomposedSound);
+        return;
+    }
+    uint64_t OptimalZero = Context.OptimalZero[Index], OptimalOne = Context.OptimalOne[Index];
+    CompositeSound = ((Composite.Zero & ~OptimalZero) | (Composite.One & ~OptimalOne)) == 0;
+    DecomposedSound = ((Decomposed.Zero & ~OptimalZero) | (Decomposed.One & ~OptimalOne)) == 0;
+}
+
+// Function to get the optimal result of the unary input with the given index and
+// masks, from the optimal table when the configuration has one and from the
+// concrete table otherwise
+inline void getOptimalMasks(const SweepContext &Context, uint64_t Index, uint64_t Zero, uint64_t One,
+                            unsigned BitWidth, uint64_t &OptimalZero, uint64_t &OptimalOne) {
+    if (Context.OptimalZero) {
+        OptimalZero = Context.OptimalZero[Index];
+        OptimalOne = Context.OptimalOne[Index];
+        return;
+    }
+    optimalFromTable(Zero, One, BitWidth, Context.ConcreteResults, OptimalZero, OptimalOne);
+}
+
+// Binary transfer function pairs. Commutative is set when both the composite and
+// the decomposed function give the same result for swapped operands, which lets
+// the binary sweep evaluate each unordered pair of operands once.
+struct AndOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &LHS, const APInt &RHS) { return LHS & RHS; }
+    static const bool Commutative = true;
+    static KnownBits composite(const KnownBits &LHS, const KnownBits &RHS) { return andComposite(LHS, RHS); }
+    static KnownBits decomposed(const KnownBits &LHS, const KnownBits &RHS) { return andDecomposed(LHS, RHS); }
+    // operator& of the linked LLVM on LHS and each of a batch of RHS operands, see --llvm
+    static void libraryBatch(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = LHS & RHS[i];
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return andCompositeFixed(LHS, RHS);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return andDecomposedFixed(LHS, RHS);
+    }
+};
+
+struct OrOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &LHS, const APInt &RHS) { return LHS | RHS; }
+    static const bool Commutative = true;
+    static KnownBits composite(const KnownBits &LHS, const KnownBits &RHS) { return orComposite(LHS, RHS); }
+    static KnownBits decomposed(const KnownBits &LHS, const KnownBits &RHS) { return orDecomposed(LHS, RHS); }
+    // operator| of the linked LLVM
+    static void libraryBatch(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = LHS | RHS[i];
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return orCompositeFixed(LHS, RHS);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return orDecomposedFixed(LHS, RHS);
+    }
+};
+
+struct XorOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &LHS, const APInt &RHS) { return LHS ^ RHS; }
+    static const bool Commutative = true;
+    static KnownBits composite(const KnownBits &LHS, const KnownBits &RHS) { return xorComposite(LHS, RHS); }
+    static KnownBits decomposed(const KnownBits &LHS, const KnownBits &RHS) { return xorDecomposed(LHS, RHS); }
+    // operator^ of the linked LLVM
+    static void libraryBatch(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = LHS ^ RHS[i];
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return xorCompositeFixed(LHS, RHS);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return xorDecomposedFixed(LHS, RHS);
+    }
+};
+
+struct AddOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &LHS, const APInt &RHS) { return LHS + RHS; }
+    static const bool Commutative = true;
+    static KnownBits composite(const KnownBits &LHS, const KnownBits &RHS) { return addComposite(LHS, RHS); }
+    static KnownBits decomposed(const KnownBits &LHS, const KnownBits &RHS) { return addDecomposed(LHS, RHS); }
+    // KnownBits::computeForAddSub of the linked LLVM
+    static void libraryBatch(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = KnownBits::computeForAddSub(/*Add=*/true, /*NSW=*/false, LHS, RHS[i]);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return addCarryCompositeFixed(LHS, RHS, /*CarryZero=*/true, /*CarryOne=*/false);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return rippleCarryFixed(LHS, RHS, /*InvertRHS=*/false, /*CarryIn=*/false);
+    }
+};
+
+struct SubOp {
+    static const unsigned Revision = 1;
+    static APInt concrete(const APInt &LHS, const APInt &RHS) { return LHS - RHS; }
+    static const bool Commutative = false;
+    static KnownBits composite(const KnownBits &LHS, const KnownBits &RHS) { return subComposite(LHS, RHS); }
+    static KnownBits decomposed(const KnownBits &LHS, const KnownBits &RHS) { return subDecomposed(LHS, RHS); }
+    // KnownBits::computeForAddSub of the linked LLVM
+    static void libraryBatch(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs, KnownBits *Results) {
+        for (unsigned i = 0; i < NumInputs; ++i)
+            Results[i] = KnownBits::computeForAddSub(/*Add=*/false, /*NSW=*/false, LHS, RHS[i]);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> compositeFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        KnownBitsFixed<N> NotRHS;
+        NotRHS.Zero = RHS.One;
+        NotRHS.One = RHS.Zero;
+        return addCarryCompositeFixed(LHS, NotRHS, /*CarryZero=*/false, /*CarryOne=*/true);
+    }
+    template <unsigned N>
+    static KnownBitsFixed<N> decomposedFixed(const KnownBitsFixed<N> &LHS, const KnownBitsFixed<N> &RHS) {
+        return rippleCarryFixed(LHS, RHS, /*InvertRHS=*/true, /*CarryIn=*/true);
+    }
+};
+
+// Function to sweep the abstract values with indices in [Begin, End) on the
+// fixed-width backend. With --differential or --cross-check every input is also
+// run through the APInt functions or the std::set comparison.
+// Returns the counters through Counts, adding to what is already there.
+template <typename Op, unsigned N>
+void sweepFixed(const SweepContext &Context, uint64_t Begin, uint64_t End, PrecisionCounts &Counts) {
+    unsigned Param = Context.Param;
+    bool NeedAPInt = Options.Differential || Options.CrossCheck;
+    KnownBitsFixed<N> KBInstance = decodeKnownBitsFixed<N>(Begin);
+    for (uint64_t i = Begin; i < End; ++i, incrementKnownBitsFixed(KBInstance)) {
+        KnownBitsFixed<N> CompositeResult = Op::compositeFixed(KBInstance, Param);
+        KnownBitsFixed<N> DecomposedResult = Op::decomposedFixed(KBInstance, Param);
+        PrecisionOrder Order = comparePrecisionFixed(CompositeResult, DecomposedResult);
+        Counts.record(Order);
+        if (Options.Distance)
+            Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult));
+        if (Context.Orders)
+            storePrecisionOrder(Context.Orders, i, Order);
+
+        if (Options.Optimal) {
+            KnownBitsFixed<N> OptimalResult;
+            getOptimalMasks(Context, i, KBInstance.Zero, KBInstance.One, N,
+                            OptimalResult.Zero, OptimalResult.One);
+            Counts.recordOptimality(comparePrecisionFixed(CompositeResult, OptimalResult),
+                                    comparePrecisionFixed(DecomposedResult, OptimalResult));
+        }
+        if (Options.Soundness) {
+            bool CompositeSound, DecomposedSound;
+            checkSoundness(Context, i, KBInstance.Zero, KBInstance.One, N, CompositeResult, DecomposedResult,
+                           CompositeSound, DecomposedSound);
+            Counts.recordSoundness(CompositeSound, DecomposedSound);
+        }
+
+        if (!NeedAPInt)
+            continue;
+        KnownBits Input = toKnownBits(KBInstance);
+        KnownBits APIntComposite = Op::composite(Input, Param);
+        KnownBits APIntDecomposed = Op::decomposed(Input, Param);
+        if (Options.Differential &&
+            (toKnownBitsFixed<N>(APIntComposite) != CompositeResult ||
+             toKnownBitsFixed<N>(APIntDecomposed) != DecomposedResult))
+            Counts.BackendMismatches++;
+        if (Options.CrossCheck && Order != comparePrecisionByConcretization(APIntComposite, APIntDecomposed))
+            Counts.CrossCheckMismatches++;
+    }
+}
+
+// The low BatchDigits bits of every position in a block are a decoder block
+static_assert(BatchDigits == TritBlockDigits, "Batches must be decoder blocks");
+
+// Function to evaluate and compare both transfer functions on one block of
+// abstract values. The lanes are kept as separate Zero/One arrays and every step
+// is a loop over the lanes with no data-dependent control flow, so the compiler
+// turns each loop into SIMD code.
+template <typename Op, unsigned N>
+void sweepBatch(const SweepContext &Context, uint64_t BlockBegin, unsigned NumLanes, PrecisionCounts &Counts) {
+    alignas(64) uint64_t Zero[BatchSize], One[BatchSize];
+    alignas(64) uint64_t CompositeZero[BatchSize], CompositeOne[BatchSize];
+    alignas(64) uint64_t DecomposedZero[BatchSize], DecomposedOne[BatchSize];
+    const uint64_t Mask = KnownBitsFixed<N>::mask();
+    unsigned Param = Context.Param;
+
+    // Inputs: decoded high digits combined with the low digits of each lane
+    KnownBitsFixed<N> High = decodeKnownBitsFixed<N>(BlockBegin / NumLanes);
+    uint64_t HighZero = (High.Zero << BatchDigits) & Mask;
+    uint64_t HighOne = (High.One << BatchDigits) & Mask;
+    for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+        Zero[Lane] = HighZero | (TritBlocks.Zero[Lane] & Mask);
+        One[Lane] = HighOne | (TritBlocks.One[Lane] & Mask);
+    }
+
+    for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+        KnownBitsFixed<N> Input;
+        Input.Zero = Zero[Lane];
+        Input.One = One[Lane];
+        KnownBitsFixed<N> Result = Op::compositeFixed(Input, Param);
+        CompositeZero[Lane] = Result.Zero;
+        CompositeOne[Lane] = Result.One;
+    }
+
+    for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+        KnownBitsFixed<N> Input;
+        Input.Zero = Zero[Lane];
+        Input.One = One[Lane];
+        KnownBitsFixed<N> Result = Op::decomposedFixed(Input, Param);
+        DecomposedZero[Lane] = Result.Zero;
+        DecomposedOne[Lane] = Result.One;
+    }
+
+    // Lattice comparison, accumulated as sums of per-lane predicates
+    uint64_t Equal = 0, CompositeMore = 0, DecomposedMore = 0;
+    for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+        uint64_t CompositeInDecomposed =
+            ((DecomposedZero[Lane] & ~CompositeZero[Lane]) | (DecomposedOne[Lane] & ~CompositeOne[Lane])) == 0;
+        uint64_t DecomposedInComposite =
+            ((CompositeZero[Lane] & ~DecomposedZero[Lane]) | (CompositeOne[Lane] & ~DecomposedOne[Lane])) == 0;
+        Equal += CompositeInDecomposed & DecomposedInComposite;
+        CompositeMore += CompositeInDecomposed & (DecomposedInComposite ^ 1);
+        DecomposedMore += DecomposedInComposite & (CompositeInDecomposed ^ 1);
+    }
+    if (Options.Distance) {
+        for (unsigned Lane = 0; Lane < NumLanes; ++Lane)
+            Counts.recordDistance(int(countPopulation(DecomposedZero[Lane] | DecomposedOne[Lane])) -
+                                  int(countPopulation(CompositeZero[Lane] | CompositeOne[Lane])));
+    }
+    if (Context.Orders) {
+        for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+            KnownBitsFixed<N> CompositeResult, DecomposedResult;
+            CompositeResult.Zero = CompositeZero[Lane];
+            CompositeResult.One = CompositeOne[Lane];
+            DecomposedResult.Zero = DecomposedZero[Lane];
+            DecomposedResult.One = DecomposedOne[Lane];
+            storePrecisionOrder(Context.Orders, BlockBegin + Lane,
+                                comparePrecisionFixed(CompositeResult, DecomposedResult));
+        }
+    }
+    Counts.TotalComparisons += NumLanes;
+    Counts.EquallyPrecise += Equal;
+    Counts.CompositeMorePrecise += CompositeMore;
+    Counts.DecomposedMorePrecise += DecomposedMore;
+    Counts.Incomparable += NumLanes - Equal - CompositeMore - DecomposedMore;
+
+    // With --differential every lane is checked against the APInt functions
+    if (Options.Differential) {
+        for (unsigned Lane = 0; Lane < NumLanes; ++Lane) {
+            KnownBitsFixed<N> Input;
+            Input.Zero = Zero[Lane];
+            Input.One = One[Lane];
+            KnownBitsFixed<N> APIntComposite = toKnownBitsFixed<N>(Op::composite(toKnownBits(Input), Param));
+            KnownBitsFixed<N> APIntDecomposed = toKnownBitsFixed<N>(Op::decomposed(toKnownBits(Input), Param));
+            if (APIntComposite.Zero != CompositeZero[Lane] || APIntComposite.One != CompositeOne[Lane] ||
+                APIntDecomposed.Zero != DecomposedZero[Lane] || APIntDecomposed.One != DecomposedOne[Lane])
+                Counts.BackendMismatches++;
+        }
+    }
+}
+
+// Function to sweep the abstract values with indices in [Begin, End) on the
+// batched backend. Whole aligned blocks go through sweepBatch and the partial
+// blocks at either end of the range through sweepFixed.
+template <typename Op, unsigned N>
+void sweepBatched(const SweepContext &Context, uint64_t Begin, uint64_t End, PrecisionCounts &Counts) {
+    // The set-based cross-check, the optimal transformer and the soundness check
+    // handle every input individually
+    if (Options.CrossCheck || Options.Optimal || Options.Soundness) {
+        sweepFixed<Op, N>(Context, Begin, End, Counts);
+        return;
+    }
+
+    const uint64_t BlockSize = N < BatchDigits ? numAbstractValues(N) : BatchSize;
+    uint64_t BlockBegin = std::min(End, alignTo(Begin, BlockSize));
+    sweepFixed<Op, N>(Context, Begin, BlockBegin, Counts);
+    for (; BlockBegin + BlockSize <= End; BlockBegin += BlockSize)
+        sweepBatch<Op, N>(Context, BlockBegin, BlockSize, Counts);
+    sweepFixed<Op, N>(Context, BlockBegin, End, Counts);
+}
+
+// The binary sweep walks the product of the abstract domain with itself in
+// square tiles of BinaryTileSize operands per side. Tiles are numbered row by row
+// and handed to workers like abstract values are for unary operations. The
+// operands of a tile row and column are decoded once and reused for every pair in
+// the tile, and both fit in L1 together with the results of one row.
+static const unsigned BinaryTileSize = 256;
+
+// Function to count the tiles along each side of the binary product space
+uint64_t numBinaryTilesPerSide(unsigned BitWidth) {
+    return divideCeil(numAbstractValues(BitWidth), BinaryTileSize);
+}
+
+// Operands of a tile side, decoded from consecutive base-3 indices
+template <unsigned N>
+struct BinaryTileOperands {
+    uint64_t Zero[BinaryTileSize];
+    uint64_t One[BinaryTileSize];
+    unsigned Size = 0;
+
+    void decode(uint64_t Begin, uint64_t End) {
+        Size = End - Begin;
+        KnownBitsFixed<N> KBInstance = decodeKnownBitsFixed<N>(Begin);
+        for (unsigned i = 0; i < Size; ++i, incrementKnownBitsFixed(KBInstance)) {
+            Zero[i] = KBInstance.Zero;
+            One[i] = KBInstance.One;
+        }
+    }
+
+    KnownBitsFixed<N> operator[](unsigned i) const {
+        KnownBitsFixed<N> KBInstance;
+        KBInstance.Zero = Zero[i];
+        KBInstance.One = One[i];
+        return KBInstance;
+    }
+};
+
+// Function to find the operand ranges of a tile. Returns false for tiles below the
+// diagonal of a commutative operation, which are covered by their mirror image.
+bool getBinaryTile(unsigned BitWidth, bool Commutative, uint64_t Tile,
+                   uint64_t &RowBegin, uint64_t &RowEnd, uint64_t &ColBegin, uint64_t &ColEnd) {
+    uint64_t TilesPerSide = numBinaryTilesPerSide(BitWidth);
+    uint64_t RowTile = Tile / TilesPerSide, ColTile = Tile % TilesPerSide;
+    if (Commutative && ColTile < RowTile)
+        return false;
+    uint64_t NumValues = numAbstractValues(BitWidth);
+    RowBegin = RowTile * BinaryTileSize;
+    RowEnd = std::min(NumValues, RowBegin + BinaryTileSize);
+    ColBegin = ColTile * BinaryTileSize;
+    ColEnd = std::min(NumValues, ColBegin + BinaryTileSize);
+    return true;
+}
+
+// Function to sweep the pairs in the tiles [TileBegin, TileEnd) on the fixed-width
+// backend. For commutative operations only pairs with the left operand index at
+// most the right one are evaluated, and pairs of distinct operands count twice.
+// With Batched the results of a tile row are computed columnwise into arrays and
+// compared with branch-free predicates, like sweepBatch does for unary operations.
+template <typename Op, unsigned N, bool Batched>
+void sweepBinaryTiles(const SweepContext &Context, uint64_t TileBegin, uint64_t TileEnd, PrecisionCounts &Counts) {
+    bool NeedAPInt = Options.Differential || Options.CrossCheck;
+    BinaryTileOperands<N> Rows, Cols;
+    alignas(64) uint64_t CompositeZero[BinaryTileSize], CompositeOne[BinaryTileSize];
+    alignas(64) uint64_t DecomposedZero[BinaryTileSize], DecomposedOne[BinaryTileSize];
+
+    for (uint64_t Tile = TileBegin; Tile < TileEnd; ++Tile) {
+        uint64_t RowBegin, RowEnd, ColBegin, ColEnd;
+        if (!getBinaryTile(N, Op::Commutative, Tile, RowBegin, RowEnd, ColBegin, ColEnd))
+            continue;
+        Rows.decode(RowBegin, RowEnd);
+        Cols.decode(ColBegin, ColEnd);
+        bool Diagonal = Op::Commutative && RowBegin == ColBegin;
+
+        for (unsigned Row = 0; Row < Rows.Size; ++Row) {
+            KnownBitsFixed<N> LHS = Rows[Row];
+            unsigned FirstCol = Diagonal ? Row : 0;
+
+            if (Batched && !NeedAPInt && !Options.Optimal && !Options.Soundness) {
+                for (unsigned Col = FirstCol; Col < Cols.Size; ++Col) {
+                    KnownBitsFixed<N> Result = Op::compositeFixed(LHS, Cols[Col]);
+                    CompositeZero[Col] = Result.Zero;
+                    CompositeOne[Col] = Result.One;
+                }
+                for (unsigned Col = FirstCol; Col < Cols.Size; ++Col) {
+                    KnownBitsFixed<N> Result = Op::decomposedFixed(LHS, Cols[Col]);
+                    DecomposedZero[Col] = Result.Zero;
+                    DecomposedOne[Col] = Result.One;
+                }
+                uint64_t Pairs = 0, Equal = 0, CompositeMore = 0, DecomposedMore = 0;
+                for (unsigned Col = FirstCol; Col < Cols.Size; ++Col) {
+                    uint64_t Weight = Diagonal && Col != Row ? 2 : 1;
+                    uint64_t CompositeInDecomposed =
+                        ((DecomposedZero[Col] & ~CompositeZero[Col]) | (DecomposedOne[Col] & ~CompositeOne[Col])) == 0;
+                    uint64_t DecomposedInComposite =
+                        ((CompositeZero[Col] & ~DecomposedZero[Col]) | (CompositeOne[Col] & ~DecomposedOne[Col])) == 0;
+                    Pairs += Weight;
+                    Equal += Weight * (CompositeInDecomposed & DecomposedInComposite);
+                    CompositeMore += Weight * (CompositeInDecomposed & (DecomposedInComposite ^ 1));
+                    DecomposedMore += Weight * (DecomposedInComposite & (CompositeInDecomposed ^ 1));
+                }
+                // Tiles off the diagonal of a commutative operation stand for their mirror too
+                uint64_t Mirror = Op::Commutative && !Diagonal ? 2 : 1;
+                if (Options.Distance) {
+                    for (unsigned Col = FirstCol; Col < Cols.Size; ++Col)
+                        Counts.recordDistance(int(countPopulation(DecomposedZero[Col] | DecomposedOne[Col])) -
+                                                  int(countPopulation(CompositeZero[Col] | CompositeOne[Col])),
+                                              Mirror * (Diagonal && Col != Row ? 2 : 1));
+                }
+                Counts.TotalComparisons += Mirror * Pairs;
+                Counts.EquallyPrecise += Mirror * Equal;
+                Counts.CompositeMorePrecise += Mirror * CompositeMore;
+                Counts.DecomposedMorePrecise += Mirror * DecomposedMore;
+                Counts.Incomparable += Mirror * (Pairs - Equal - CompositeMore - DecomposedMore);
+                continue;
+            }
+
+            for (unsigned Col = FirstCol; Col < Cols.Size; ++Col) {
+                KnownBitsFixed<N> RHS = Cols[Col];
+                uint64_t Weight = Op::Commutative && (!Diagonal || Col != Row) ? 2 : 1;
+                KnownBitsFixed<N> CompositeResult = Op::compositeFixed(LHS, RHS);
+                KnownBitsFixed<N> DecomposedResult = Op::decomposedFixed(LHS, RHS);
+                PrecisionOrder Order = comparePrecisionFixed(CompositeResult, DecomposedResult);
+                Counts.record(Order, Weight);
+                if (Options.Distance)
+                    Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult), Weight);
+
+                if (Options.Optimal) {
+                    // The concrete results are indexed by both operands side by side
+                    KnownBitsFixed<N> OptimalResult;
+                    optimalFromTable((LHS.Zero << N) | RHS.Zero, (LHS.One << N) | RHS.One, 2 * N,
+                                     Context.ConcreteResults, OptimalResult.Zero, OptimalResult.One);
+                    OptimalResult.Zero &= KnownBitsFixed<N>::mask();
+                    OptimalResult.One &= KnownBitsFixed<N>::mask();
+                    Counts.recordOptimality(comparePrecisionFixed(CompositeResult, OptimalResult),
+                                            comparePrecisionFixed(DecomposedResult, OptimalResult), Weight);
+                }
+                if (Options.Soundness) {
+                    bool CompositeSound, DecomposedSound;
+                    checkSoundnessFromTable((LHS.Zero << N) | RHS.Zero, (LHS.One << N) | RHS.One, 2 * N,
+                                            Context.ConcreteResults, CompositeResult, DecomposedResult,
+                                            CompositeSound, DecomposedSound);
+                    Counts.recordSoundness(CompositeSound, DecomposedSound, Weight);
+                }
+
+                if (!NeedAPInt)
+                    continue;
+                KnownBits APIntComposite = Op::composite(toKnownBits(LHS), toKnownBits(RHS));
+                KnownBits APIntDecomposed = Op::decomposed(toKnownBits(LHS), toKnownBits(RHS));
+                if (Options.Differential &&
+                    (toKnownBitsFixed<N>(APIntComposite) != CompositeResult ||
+                     toKnownBitsFixed<N>(APIntDecomposed) != DecomposedResult))
+                    Counts.BackendMismatches += Weight;
+                if (Options.CrossCheck && Order != comparePrecisionByConcretization(APIntComposite, APIntDecomposed))
+                    Counts.CrossCheckMismatches += Weight;
+            }
+        }
+    }
+}
+
+typedef void (*FixedSweepFn)(const SweepContext &Context, uint64_t Begin, uint64_t End, PrecisionCounts &Counts);
+typedef std::array<FixedSweepFn, 64> FixedSweepTable;
+
+template <typename Op, size_t... Widths>
+constexpr FixedSweepTable makeBinarySweepTable(std::index_sequence<Widths...>) {
+    return {{&sweepBinaryTiles<Op, Widths + 1, false>...}};
+}
+
+template <typename Op, size_t... Widths>
+constexpr FixedSweepTable makeBinaryBatchedSweepTable(std::index_sequence<Widths...>) {
+    return {{&sweepBinaryTiles<Op, Widths + 1, true>...}};
+}
+
+template <typename Op, size_t... Widths>
+constexpr FixedSweepTable makeFixedSweepTable(std::index_sequence<Widths...>) {
+    return {{&sweepFixed<Op, Widths + 1>...}};
+}
+
+template <typename Op, size_t... Widths>
+constexpr FixedSweepTable makeBatchedSweepTable(std::index_sequence<Widths...>) {
+    return {{&sweepBatched<Op, Widths + 1>...}};
+}
+
+// sweepFixed and sweepBatched of an operation instantiated for every bitwidth
+// from 1 to 64, indexed by BitWidth - 1
+template <typename Op>
+struct FixedSweeps {
+    static const FixedSweepTable Scalar;
+    static const FixedSweepTable Batched;
+};
+
+template <typename Op>
+const FixedSweepTable FixedSweeps<Op>::Scalar = makeFixedSweepTable<Op>(std::make_index_sequence<64>());
+
+template <typename Op>
+const FixedSweepTable FixedSweeps<Op>::Batched = makeBatchedSweepTable<Op>(std::make_index_sequence<64>());
+
+// Largest bitwidth with fixed-width binary sweeps. The product space is already
+// 3^32 pairs at this width, so larger instantiations would only cost build time.
+static const unsigned MaxBinaryFixedBitWidth = 16;
+
+// Tile sweeps of a binary operation for every bitwidth from 1 to
+// MaxBinaryFixedBitWidth, with null entries above
+template <typename Op>
+struct BinaryFixedSweeps {
+    static const FixedSweepTable Scalar;
+    static const FixedSweepTable Batched;
+};
+
+template <typename Op>
+const FixedSweepTable BinaryFixedSweeps<Op>::Scalar =
+    makeBinarySweepTable<Op>(std::make_index_sequence<MaxBinaryFixedBitWidth>());
+
+template <typename Op>
+const FixedSweepTable BinaryFixedSweeps<Op>::Batched =
+    makeBinaryBatchedSweepTable<Op>(std::make_index_sequence<MaxBinaryFixedBitWidth>());
+
+// Meaning of the unsigned parameter passed to a transfer function along with its operands
+enum class ParamKind {
+    None,        // No parameter, the sweep passes 0
+    SrcBitWidth, // Width of the source value, from 1 to BitWidth
+    ShiftAmount  // Constant shift amount, from 0 to BitWidth - 1
+};
+
+typedef KnownBits (*UnaryTransferFn)(const KnownBits &KBInstance, unsigned Param);
+typedef KnownBits (*BinaryTransferFn)(const KnownBits &LHS, const KnownBits &RHS);
+typedef APInt (*UnaryConcreteFn)(const APInt &Value, unsigned Param);
+typedef APInt (*BinaryConcreteFn)(const APInt &LHS, const APInt &RHS);
+typedef std::pair<unsigned, unsigned> (*SupportFn)(unsigned BitWidth, unsigned Param);
+typedef void (*UnaryLibraryBatchFn)(const KnownBits *Inputs, unsigned NumInputs, unsigned Param, KnownBits *Results);
+typedef void (*BinaryLibraryBatchFn)(const KnownBits &LHS, const KnownBits *RHS, unsigned NumInputs,
+                                     KnownBits *Results);
+
+// A registered pair of composite and decomposed transfer functions. Unary
+// operations fill in Composite/Decomposed/Concrete and binary ones
+// CompositeBinary/DecomposedBinary/ConcreteBinary. The fixed-width sweep tables take abstract
+// value indices for unary operations and tile indices for binary ones.
+struct TransferFunctionInfo {
+    const char *Name;
+    const char *Description;
+    unsigned Revision;      // Revision of the functions, part of the --incremental fingerprint
+    unsigned Arity;         // Number of KnownBits operands
+    ParamKind Param;
+    bool Commutative;
+    UnaryTransferFn Composite;
+    UnaryTransferFn Decomposed;
+    UnaryTransferIntoFn CompositeInto;    // In-place versions of Composite and Decomposed
+    UnaryTransferIntoFn DecomposedInto;
+    BinaryTransferFn CompositeBinary;
+    BinaryTransferFn DecomposedBinary;
+    UnaryConcreteFn Concrete;
+    BinaryConcreteFn ConcreteBinary;
+    UnaryLibraryBatchFn Library;          // The linked LLVM's KnownBits API for the operation, see --llvm
+    BinaryLibraryBatchFn LibraryBinary;
+    SupportFn Support;      // Input bits [first, second) that both unary functions read, see --generalize
+    bool MaskDetermined;    // Known result bits depend only on the input's unknown-bit mask, see --group-by-mask
+    unsigned StaticBitWidth; // Bitwidths up to which every input compares equal, checked at compile time
+    const FixedSweepTable *ScalarSweeps;
+    const FixedSweepTable *BatchedSweeps;
+};
+
+template <typename Op>
+TransferFunctionInfo makeUnaryTransferFunction(const char *Name, const char *Description, ParamKind Param) {
+    return {Name, Description, Op::Revision, 1, Param, false, &Op::composite, &Op::decomposed,
+            &Op::compositeInto, &Op::decomposedInto, nullptr, nullptr, &Op::concrete, nullptr, &Op::libraryBatch,
+            nullptr, &Op::support,
+            Op::MaskDetermined, Op::StaticBitWidth, &FixedSweeps<Op>::Scalar, &FixedSweeps<Op>::Batched};
+}
+
+template <typename Op>
+TransferFunctionInfo makeBinaryTransferFunction(const char *Name, const char *Description) {
+    return {Name, Description, Op::Revision, 2, ParamKind::None, Op::Commutative, nullptr, nullptr, nullptr, nullptr,
+            &Op::composite, &Op::decomposed, nullptr, &Op::concrete, nullptr, &Op::libraryBatch, nullptr, false, 0,
+            &BinaryFixedSweeps<Op>::Scalar, &BinaryFixedSweeps<Op>::Batched};
+}
+
+// Every transfer function pair the harness can verify, in the order they run
+static const std::vector<TransferFunctionInfo> TransferFunctions = {
+    makeUnaryTransferFunction<SextInRegOp>("sextInReg", "sign extension from the low SrcBitWidth bits",
+                                           ParamKind::SrcBitWidth),
+    makeUnaryTransferFunction<ZextInRegOp>("zextInReg", "zero extension from the low SrcBitWidth bits",
+                                           ParamKind::SrcBitWidth),
+    makeUnaryTransferFunction<ShlOp>("shl", "shift left by a constant", ParamKind::ShiftAmount),
+    makeUnaryTransferFunction<LshrOp>("lshr", "logical shift right by a constant", ParamKind::ShiftAmount),
+    makeUnaryTransferFunction<AshrOp>("ashr", "arithmetic shift right by a constant", ParamKind::ShiftAmount),
+    makeBinaryTransferFunction<AndOp>("and", "bitwise and"),
+    makeBinaryTransferFunction<OrOp>("or", "bitwise or"),
+    makeBinaryTransferFunction<XorOp>("xor", "bitwise xor"),
+    makeBinaryTransferFunction<AddOp>("add", "addition"),
+    makeBinaryTransferFunction<SubOp>("sub", "subtraction"),
+};
+
+// Function to look up a registered transfer function pair by name
+const TransferFunctionInfo *findTransferFunction(StringRef Name) {
+    for (const TransferFunctionInfo &Info : TransferFunctions)
+        if (Name == Info.Name)
+            return &Info;
+    return nullptr;
+}
+
+// Function to get the name of the parameter of a transfer function pair
+const char *getParamName(ParamKind Kind) {
+    switch (Kind) {
+    case ParamKind::None:
+        return "None";
+    case ParamKind::SrcBitWidth:
+        return "SrcBitWidth";
+    case ParamKind::ShiftAmount:
+        return "ShiftAmount";
+    }
+    llvm_unreachable("Unknown parameter kind");
+}
+
+// Function to get the smallest and largest parameter to sweep for a bitwidth
+std::pair<unsigned, unsigned> getParamRange(ParamKind Kind, unsigned BitWidth) {
+    switch (Kind) {
+    case ParamKind::None:
+        return {0, 0};
+    case ParamKind::SrcBitWidth:
+        return {1, BitWidth};
+    case ParamKind::ShiftAmount:
+        return {0, BitWidth - 1};
+    }
+    llvm_unreachable("Unknown parameter kind");
+}
+
+// Function to get the parameters to sweep for a bitwidth, in increasing order:
+// those of its range selected by --param, or all of them. Operations without a
+// parameter sweep 0 either way.
+SmallVector<unsigned, 16> getSweptParams(ParamKind Kind, unsigned BitWidth) {
+    std::pair<unsigned, unsigned> Range = getParamRange(Kind, BitWidth);
+    SmallVector<unsigned, 16> Params;
+    for (unsigned Param = Range.first; Param <= Range.second; ++Param) {
+        bool Selected = Kind == ParamKind::None || Options.ParamRanges.empty();
+        for (const std::pair<unsigned, unsigned> &Selection : Options.ParamRanges)
+            Selected |= Selection.first <= Param && Param <= Selection.second;
+        if (Selected)
+            Params.push_back(Param);
+    }
+    return Params;
+}
+
+// Function to tabulate the concrete operation of Op for every concrete input at a
+// bitwidth. Unary results are indexed by the input value and binary ones by
+// (LHS << BitWidth) | RHS. The table is built once per configuration so that each
+// concrete input is evaluated once, however many abstract values contain it.
+std::vector<uint64_t> buildConcreteTable(ThreadPool &Pool, const TransferFunctionInfo &Op,
+                                         unsigned BitWidth, unsigned Param) {
+    bool Binary = Op.Arity == 2;
+    std::vector<uint64_t> Table(uint64_t(1) << (Binary ? 2 * BitWidth : BitWidth));
+    parallelForChunks(Pool, Table.size(), SweepChunkSize, [&](unsigned, uint64_t Begin, uint64_t End) {
+        for (uint64_t Input = Begin; Input < End; ++Input) {
+            if (Binary) {
+                APInt LHS(BitWidth, Input >> BitWidth), RHS(BitWidth, Input & maskTrailingOnes<uint64_t>(BitWidth));
+                Table[Input] = Op.ConcreteBinary(LHS, RHS).getZExtValue();
+            } else {
+                Table[Input] = Op.Concrete(APInt(BitWidth, Input), Param).getZExtValue();
+            }
+        }
+    });
+    return Table;
+}
+
+// Largest bitwidth whose abstract values --optimal and --soundness tabulate, 3^14
+// values or 77MB of masks per table
+static const unsigned MaxOptimalTableBitWidth = 14;
+
+// Zero/One masks of every abstract value of a bitwidth in base-3 index order. The
+// domain is enumerated once per bitwidth and shared by every operation and
+// parameter swept at it.
+struct AbstractDomainTable {
+    unsigned BitWidth = 0;
+    std::vector<uint64_t> Zero, One;
+    std::vector<uint64_t> DigitWeights; // 3^Bit, the index distance between digits of bit Bit
+};
+
+// Function to enumerate the abstract domain of a bitwidth into Domain
+void buildAbstractDomainTable(ThreadPool &Pool, unsigned BitWidth, AbstractDomainTable &Domain) {
+    uint64_t NumValues = numAbstractValues(BitWidth);
+    Domain.BitWidth = BitWidth;
+    Domain.Zero.resize(NumValues);
+    Domain.One.resize(NumValues);
+    Domain.DigitWeights.resize(BitWidth);
+    for (unsigned Bit = 0; Bit < BitWidth; ++Bit)
+        Domain.DigitWeights[Bit] = Bit == 0 ? 1 : 3 * Domain.DigitWeights[Bit - 1];
+    parallelForChunks(Pool, NumValues, SweepChunkSize, [&](unsigned, uint64_t Begin, uint64_t End) {
+        uint64_t Zero, One;
+        decodeKnownBitsMasks(Begin, BitWidth, Zero, One);
+        for (uint64_t i = Begin; i < End; ++i, incrementKnownBitsMasks(Zero, One, BitWidth)) {
+            Domain.Zero[i] = Zero;
+            Domain.One[i] = One;
+        }
+    });
+}
+
+// Function to tabulate the optimal transformer of a unary operation for every
+// abstract value of Domain, given its concrete results. An abstract value with an
+// unknown bit concretizes to the union of the values with that bit known zero and
+// known one, so its optimal result is the meet of theirs. Splitting the lowest
+// unknown bit gives two values with smaller indices, so one pass in index order
+// costs a single meet per abstract value instead of a walk over its concrete
+// values, 3^W steps in total rather than 4^W.
+void buildOptimalTable(const AbstractDomainTable &Domain, const std::vector<uint64_t> &ConcreteResults,
+                       std::vector<uint64_t> &OptimalZero, std::vector<uint64_t> &OptimalOne) {
+    uint64_t NumValues = Domain.Zero.size();
+    uint64_t Mask = maskTrailingOnes<uint64_t>(Domain.BitWidth);
+    OptimalZero.resize(NumValues);
+    OptimalOne.resize(NumValues);
+    for (uint64_t i = 0; i < NumValues; ++i) {
+        uint64_t Unknown = ~(Domain.Zero[i] | Domain.One[i]) & Mask;
+        if (Unknown == 0) {
+            uint64_t Result = ConcreteResults[Domain.One[i]];
+            OptimalZero[i] = ~Result & Mask;
+            OptimalOne[i] = Result;
+            continue;
+        }
+        // The lowest unknown digit is 2, so the values with a 0 or 1 there are
+        // one or two digit weights below
+        uint64_t Weight = Domain.DigitWeights[countTrailingZeros(Unknown)];
+        OptimalZero[i] = OptimalZero[i - Weight] & OptimalZero[i - 2 * Weight];
+        OptimalOne[i] = OptimalOne[i - Weight] & OptimalOne[i - 2 * Weight];
+    }
+}
+
+// Function to compute the optimal transformer of the unary APInt input with the
+// given index, see getOptimalMasks
+KnownBits getOptimalResult(const SweepContext &Context, uint64_t Index, const KnownBits &Input) {
+    unsigned BitWidth = Input.getBitWidth();
+    uint64_t OptimalZero, OptimalOne;
+    getOptimalMasks(Context, Index, Input.Zero.getZExtValue(), Input.One.getZExtValue(), BitWidth,
+                    OptimalZero, OptimalOne);
+    KnownBits Result(BitWidth);
+    Result.Zero = APInt(BitWidth, OptimalZero);
+    Result.One = APInt(BitWidth, OptimalOne);
+    return Result;
+}
+
+// Function to compute the optimal transformer of a binary APInt input with
+// optimalFromTable
+KnownBits getOptimalResult(const SweepContext &Context, const KnownBits &LHS, const KnownBits &RHS) {
+    unsigned BitWidth = LHS.getBitWidth();
+    uint64_t Zero = (LHS.Zero.getZExtValue() << BitWidth) | RHS.Zero.getZExtValue();
+    uint64_t One = (LHS.One.getZExtValue() << BitWidth) | RHS.One.getZExtValue();
+    uint64_t OptimalZero, OptimalOne;
+    optimalFromTable(Zero, One, 2 * BitWidth, Context.ConcreteResults, OptimalZero, OptimalOne);
+    uint64_t Mask = maskTrailingOnes<uint64_t>(BitWidth);
+    KnownBits Result(BitWidth);
+    Result.Zero = APInt(BitWidth, OptimalZero & Mask);
+    Result.One = APInt(BitWidth, OptimalOne & Mask);
+    return Result;
+}
+
+// Zero/One masks of a KnownBits value of at most 64 bits, for checkSoundnessFromTable
+struct KnownBitsMasks {
+    uint64_t Zero, One;
+    explicit KnownBitsMasks(const KnownBits &KBInstance)
+        : Zero(KBInstance.Zero.getZExtValue()), One(KBInstance.One.getZExtValue()) {}
+};
+
+// Function to test whether two KnownBits values have the same masks
+inline bool sameKnownBits(const KnownBits &A, const KnownBits &B) {
+    return A.Zero == B.Zero && A.One == B.One;
+}
+
+// Function to sweep the abstract values with indices in [Begin, End) through the
+// APInt functions of a unary operation. The input and both results are allocated
+// once per chunk and updated in place, so wide bitwidths do not allocate per value.
+// With --llvm, the linked LLVM's function runs on blocks of BatchSize inputs
+// ahead of the per-input loop, and each composite result is checked against it.
+void sweepAPInt(const TransferFunctionInfo &Op, unsigned BitWidth, const SweepContext &Context,
+                uint64_t Begin, uint64_t End, PrecisionCounts &Counts) {
+    KnownBitsRange Range(BitWidth, Begin, End);
+    KnownBits CompositeResult(BitWidth), DecomposedResult(BitWidth);
+    std::vector<KnownBits> LibraryInputs, LibraryResults;
+    uint64_t LibraryBegin = Begin, LibraryEnd = Begin;
+    for (KnownBitsRange::iterator It = Range.begin(), E = Range.end(); It != E; ++It) {
+        const KnownBits &KBInstance = *It;
+        Op.CompositeInto(KBInstance, Context.Param, CompositeResult);
+        Op.DecomposedInto(KBInstance, Context.Param, DecomposedResult);
+
+        if (Options.Library) {
+            if (It.index() == LibraryEnd) {
+                LibraryBegin = LibraryEnd;
+                LibraryEnd = std::min(End, LibraryBegin + BatchSize);
+                KnownBitsRange Block(BitWidth, LibraryBegin, LibraryEnd);
+                LibraryInputs.assign(Block.begin(), Block.end());
+                LibraryResults.resize(LibraryInputs.size(), KnownBits(BitWidth));
+                Op.Library(LibraryInputs.data(), LibraryInputs.size(), Context.Param, LibraryResults.data());
+            }
+            if (!sameKnownBits(CompositeResult, LibraryResults[It.index() - LibraryBegin]))
+                Counts.LibraryMismatches++;
+        }
+
+        // Check which result is more precise
+        PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+        if (Options.CrossCheck && Order != comparePrecisionByConcretization(CompositeResult, DecomposedResult))
+            Counts.CrossCheckMismatches++;
+        Counts.record(Order);
+        if (Options.Distance)
+            Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult));
+        if (Context.Orders)
+            storePrecisionOrder(Context.Orders, It.index(), Order);
+
+        if (Options.Optimal) {
+            KnownBits OptimalResult = getOptimalResult(Context, It.index(), KBInstance);
+            Counts.recordOptimality(comparePrecision(CompositeResult, OptimalResult),
+                                    comparePrecision(DecomposedResult, OptimalResult));
+        }
+        if (Options.Soundness) {
+            bool CompositeSound, DecomposedSound;
+            checkSoundness(Context, It.index(), KBInstance.Zero.getZExtValue(), KBInstance.One.getZExtValue(),
+                           BitWidth, KnownBitsMasks(CompositeResult), KnownBitsMasks(DecomposedResult),
+                           CompositeSound, DecomposedSound);
+            Counts.recordSoundness(CompositeSound, DecomposedSound);
+        }
+    }
+}
+
+// Function to sweep the operand pairs in the tiles [TileBegin, TileEnd) through
+// the APInt functions of a binary operation, see sweepBinaryTiles
+void sweepBinaryAPInt(const TransferFunctionInfo &Op, unsigned BitWidth, const SweepContext &Context,
+                      uint64_t TileBegin, uint64_t TileEnd, PrecisionCounts &Counts) {
+    std::vector<KnownBits> Rows, Cols, LibraryResults;
+    for (uint64_t Tile = TileBegin; Tile < TileEnd; ++Tile) {
+        uint64_t RowBegin, RowEnd, ColBegin, ColEnd;
+        if (!getBinaryTile(BitWidth, Op.Commutative, Tile, RowBegin, RowEnd, ColBegin, ColEnd))
+            continue;
+        KnownBitsRange RowRange(BitWidth, RowBegin, RowEnd), ColRange(BitWidth, ColBegin, ColEnd);
+        Rows.assign(RowRange.begin(), RowRange.end());
+        Cols.assign(ColRange.begin(), ColRange.end());
+        bool Diagonal = Op.Commutative && RowBegin == ColBegin;
+
+        for (unsigned Row = 0; Row < Rows.size(); ++Row) {
+            // With --llvm, the linked LLVM's function runs on the row's pairs at once
+            unsigned FirstCol = Diagonal ? Row : 0;
+            if (Options.Library) {
+                LibraryResults.resize(Cols.size(), KnownBits(BitWidth));
+                Op.LibraryBinary(Rows[Row], Cols.data() + FirstCol, Cols.size() - FirstCol,
+                                 LibraryResults.data() + FirstCol);
+            }
+            for (unsigned Col = FirstCol; Col < Cols.size(); ++Col) {
+                uint64_t Weight = Op.Commutative && (!Diagonal || Col != Row) ? 2 : 1;
+                KnownBits CompositeResult = Op.CompositeBinary(Rows[Row], Cols[Col]);
+                KnownBits DecomposedResult = Op.DecomposedBinary(Rows[Row], Cols[Col]);
+                if (Options.Library && !sameKnownBits(CompositeResult, LibraryResults[Col]))
+                    Counts.LibraryMismatches += Weight;
+
+                PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+                if (Options.CrossCheck && Order != comparePrecisionByConcretization(CompositeResult, DecomposedResult))
+                    Counts.CrossCheckMismatches += Weight;
+                Counts.record(Order, Weight);
+                if (Options.Distance)
+                    Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult), Weight);
+
+                if (Options.Optimal) {
+                    KnownBits OptimalResult = getOptimalResult(Context, Rows[Row], Cols[Col]);
+                    Counts.recordOptimality(comparePrecision(CompositeResult, OptimalResult),
+                                            comparePrecision(DecomposedResult, OptimalResult), Weight);
+                }
+                if (Options.Soundness) {
+                    // The concrete results are indexed by both operands side by side
+                    const KnownBits &LHS = Rows[Row], &RHS = Cols[Col];
+                    bool CompositeSound, DecomposedSound;
+                    checkSoundnessFromTable((LHS.Zero.getZExtValue() << BitWidth) | RHS.Zero.getZExtValue(),
+                                            (LHS.One.getZExtValue() << BitWidth) | RHS.One.getZExtValue(),
+                                            2 * BitWidth, Context.ConcreteResults, KnownBitsMasks(CompositeResult),
+                                            KnownBitsMasks(DecomposedResult), CompositeSound, DecomposedSound);
+                    Counts.recordSoundness(CompositeSound, DecomposedSound, Weight);
+                }
+            }
+        }
+    }
+}
+
+// Largest number of inputs of a generalized configuration whose invariant is
+// checked; larger configurations check an evenly spaced sample of that size
+static const uint64_t MaxSupportChecks = 59049; // 3^10
+
+// Function to sweep the inputs of a unary configuration whose functions only
+// read the input bits [Lo, Hi). Those bits take every abstract value in
+// [Begin, End) while the others stay unknown, and as both results are the same
+// for every input that agrees on [Lo, Hi), each sweep input stands for
+// 3^(BitWidth - (Hi - Lo)) inputs; the caller scales the counts by that weight.
+// The invariant is checked rather than assumed: inputs whose index is a multiple
+// of CheckStride are also run with the other bits known zero and known one, and
+// InvariantHolds is cleared if either result changes. Inputs are only counted
+// when Count is set.
+void sweepGeneralized(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param, unsigned Lo, unsigned Hi,
+                      uint64_t Begin, uint64_t End, uint64_t CheckStride, bool Count, PrecisionCounts &Counts,
+                      std::atomic<bool> &InvariantHolds) {
+    APInt Outside = ~APInt::getBitsSet(BitWidth, Lo, Hi);
+    KnownBits Input(BitWidth), Filled(BitWidth);
+    KnownBits CompositeResult(BitWidth), DecomposedResult(BitWidth), FilledResult(BitWidth);
+    KnownBitsRange Range(Hi - Lo, Begin, End);
+    for (KnownBitsRange::iterator It = Range.begin(), E = Range.end(); It != E; ++It) {
+        bool Check = It.index() % CheckStride == 0;
+        if (!Count && !Check)
+            continue;
+        Input.Zero.clearAllBits();
+        Input.One.clearAllBits();
+        Input.Zero.insertBits(It->Zero, Lo);
+        Input.One.insertBits(It->One, Lo);
+        Op.CompositeInto(Input, Param, CompositeResult);
+        Op.DecomposedInto(Input, Param, DecomposedResult);
+
+        if (Count) {
+            PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+            if (Options.CrossCheck && Order != comparePrecisionByConcretization(CompositeResult, DecomposedResult))
+                Counts.CrossCheckMismatches++;
+            Counts.record(Order);
+            if (Options.Distance)
+                Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult));
+        }
+        if (!Check)
+            continue;
+
+        for (unsigned FillOne = 0; FillOne < 2; ++FillOne) {
+            Filled = Input;
+            if (FillOne)
+                Filled.One |= Outside;
+            else
+                Filled.Zero |= Outside;
+            Op.CompositeInto(Filled, Param, FilledResult);
+            bool Same = sameKnownBits(FilledResult, CompositeResult);
+            Op.DecomposedInto(Filled, Param, FilledResult);
+            if (!Same || !sameKnownBits(FilledResult, DecomposedResult))
+                InvariantHolds = false;
+        }
+    }
+}
+
+// Number of unknown-bit masks of a configuration whose classes are also checked
+// at evenly spaced fills, and the largest number of fills checked in each
+static const uint64_t MaxMaskChecks = 1024;
+static const uint64_t MaxFillChecks = 64;
+
+// Function to deposit the low bits of Value at the set positions of Mask, lowest first
+inline uint64_t depositBits(uint64_t Value, uint64_t Mask) {
+    uint64_t Result = 0;
+    for (uint64_t Bit = 1; Mask != 0; Bit <<= 1) {
+        uint64_t Lowest = Mask & -Mask;
+        if (Value & Bit)
+            Result |= Lowest;
+        Mask ^= Lowest;
+    }
+    return Result;
+}
+
+// Function to test whether two KnownBits values know the same bits, whatever their values
+inline bool sameKnownPositions(const KnownBits &A, const KnownBits &B) {
+    return (A.Zero | A.One) == (B.Zero | B.One);
+}
+
+// Function to sweep the unknown-bit masks [Begin, End) of a unary configuration
+// whose functions are MaskDetermined. The inputs with unknown mask U form a class
+// of 2^k fills of their k known bits. When both results know the same bits for
+// every fill and agree where they overlap, every fill compares alike, so the
+// class is settled by its all-zero fill and counted with weight 2^k. That is
+// checked rather than assumed: every class also runs its all-one fill, classes
+// whose mask is a multiple of CheckStride run up to MaxFillChecks evenly spaced
+// fills, and InvariantHolds is cleared if any of them compares differently.
+void sweepGroupedByMask(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param, uint64_t Begin,
+                        uint64_t End, uint64_t CheckStride, PrecisionCounts &Counts, uint64_t &Evaluated,
+                        std::atomic<bool> &InvariantHolds) {
+    uint64_t AllBits = maskTrailingOnes<uint64_t>(BitWidth);
+    KnownBits Input(BitWidth);
+    KnownBits CompositeResult(BitWidth), DecomposedResult(BitWidth);
+    KnownBits FillComposite(BitWidth), FillDecomposed(BitWidth);
+
+    // Function to run both functions on the input of the class with known bits
+    // Known whose known ones are Fill
+    auto evaluate = [&](uint64_t Known, uint64_t Fill, KnownBits &Composite, KnownBits &Decomposed) {
+        Input.Zero = Known & ~Fill;
+        Input.One = Fill;
+        Op.CompositeInto(Input, Param, Composite);
+        Op.DecomposedInto(Input, Param, Decomposed);
+        ++Evaluated;
+    };
+
+    for (uint64_t Unknown = Begin; Unknown < End && InvariantHolds; ++Unknown) {
+        uint64_t Known = AllBits & ~Unknown;
+        unsigned NumKnown = countPopulation(Known);
+        evaluate(Known, 0, CompositeResult, DecomposedResult);
+        PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+        bool Agree = ((CompositeResult.Zero & DecomposedResult.One) | (CompositeResult.One & DecomposedResult.Zero))
+                         .isNullValue();
+
+        // The all-one fill, then the evenly spaced ones of a checked class
+        uint64_t NumFills = uint64_t(1) << NumKnown;
+        uint64_t NumChecks = Unknown % CheckStride == 0 ? std::min(NumFills, MaxFillChecks) : 0;
+        for (uint64_t Check = 0; Agree && Check <= NumChecks; ++Check) {
+            uint64_t Fill = Check == 0 ? Known : depositBits(Check * (NumFills / NumChecks), Known);
+            evaluate(Known, Fill, FillComposite, FillDecomposed);
+            Agree = sameKnownPositions(FillComposite, CompositeResult) &&
+                    sameKnownPositions(FillDecomposed, DecomposedResult) &&
+                    comparePrecision(FillComposite, FillDecomposed) == Order;
+        }
+        if (!Agree) {
+            InvariantHolds = false;
+            return;
+        }
+
+        uint64_t Weight = NumFills;
+        if (Options.CrossCheck && Order != comparePrecisionByConcretization(CompositeResult, DecomposedResult))
+            Counts.CrossCheckMismatches += Weight;
+        Counts.record(Order, Weight);
+        if (Options.Distance)
+            Counts.recordDistance(getPrecisionDistance(CompositeResult, DecomposedResult), Weight);
+    }
+}
+
+// Names of the counters in forEachCounter order, for the structured reports
+static const char *const CounterNames[] = {
+    "total", "composite_more_precise", "decomposed_more_precise", "equal_precision", "incomparable",
+    "cross_check_mismatches", "backend_mismatches", "composite_optimal", "composite_suboptimal",
+    "composite_unsound", "decomposed_optimal", "decomposed_suboptimal", "decomposed_unsound", "store_mismatches",
+    "llvm_mismatches"};
+
+// Function to print the header row of --format csv
+void printCSVHeader() {
+    std::cout << "op,bitwidth,param";
+    for (const char *Name : CounterNames)
+        std::cout << "," << Name;
+    std::cout << ",distance,evaluated,wall_seconds\n";
+}
+
+// Function to print the report of a configuration. EvaluatedValues is the number
+// of inputs the sweep ran, which --generalize and --group-by-mask report.
+// Structured reports carry every counter whether or not its check ran, so their
+// columns never change, and the wall time of the configuration, negative if it
+// is not known.
+void printPrecisionCounts(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                          const PrecisionCounts &Counts, uint64_t EvaluatedValues, double WallSeconds) {
+    if (Options.Format != OutputFormat::Text) {
+        bool JSON = Options.Format == OutputFormat::JSON;
+        PrecisionCounts Fields = Counts;
+        const char *const *Name = CounterNames;
+        if (JSON)
+            std::cout << "{\"op\":\"" << Op.Name << "\",\"bitwidth\":" << BitWidth << ",\"param\":" << Param;
+        else
+            std::cout << Op.Name << "," << BitWidth << "," << Param;
+        Fields.forEachCounter([&](uint64_t &Counter) {
+            if (JSON)
+                std::cout << ",\"" << *Name << "\":";
+            else
+                std::cout << ",";
+            std::cout << Counter;
+            ++Name;
+        });
+        std::cout << (JSON ? ",\"distance\":{" : ",");
+        const char *Separator = "";
+        for (unsigned Bin = 0; Bin < array_lengthof(Counts.DistanceBins); ++Bin) {
+            if (Counts.DistanceBins[Bin] == 0)
+                continue;
+            int Distance = int(Bin) - int(MaxExhaustiveBitWidth);
+            if (JSON)
+                std::cout << Separator << "\"" << Distance << "\":" << Counts.DistanceBins[Bin];
+            else
+                std::cout << Separator << Distance << ":" << Counts.DistanceBins[Bin];
+            Separator = JSON ? "," : " ";
+        }
+        std::cout << (JSON ? "}" : "");
+        std::cout << (JSON ? ",\"evaluated\":" : ",") << EvaluatedValues << (JSON ? ",\"wall_seconds\":" : ",");
+        if (WallSeconds >= 0)
+            std::cout << WallSeconds;
+        else if (JSON)
+            std::cout << "null";
+        std::cout << (JSON ? "}\n" : "\n");
+        return;
+    }
+
+    std::cout << "Operation: " << Op.Name << "\n";
+    std::cout << "BitWidth: " << BitWidth;
+    if (Op.Param != ParamKind::None)
+        std::cout << ", " << getParamName(Op.Param) << ": " << Param;
+    std::cout << "\n";
+    std::cout << "Total Values: " << Counts.TotalComparisons << "\n";
+    if (Options.Generalize || Options.GroupByMask)
+        std::cout << "Evaluated Values: " << EvaluatedValues << "\n";
+    std::cout << "Equal Precision: " << Counts.EquallyPrecise << "\n";
+    std::cout << "Composite More Precise: " << Counts.CompositeMorePrecise << "\n";
+    std::cout << "Decomposed More Precise: " << Counts.DecomposedMorePrecise << "\n";
+    std::cout << "Incomparable Results: " << Counts.Incomparable << "\n";
+    if (Options.CrossCheck)
+        std::cout << "Cross-check Mismatches: " << Counts.CrossCheckMismatches << "\n";
+    if (Options.Differential)
+        std::cout << "Backend Mismatches: " << Counts.BackendMismatches << "\n";
+    if (!Options.DiffPath.empty())
+        std::cout << "Store Mismatches: " << Counts.StoreMismatches << "\n";
+    if (Options.Library)
+        std::cout << "LLVM Mismatches: " << Counts.LibraryMismatches << "\n";
+    if (Options.Optimal) {
+        std::cout << "Composite Optimal: " << Counts.CompositeOptimal << "\n";
+        std::cout << "Composite Suboptimal: " << Counts.CompositeSuboptimal << "\n";
+        std::cout << "Composite Unsound: " << Counts.CompositeUnsound << "\n";
+        std::cout << "Decomposed Optimal: " << Counts.DecomposedOptimal << "\n";
+        std::cout << "Decomposed Suboptimal: " << Counts.DecomposedSuboptimal << "\n";
+        std::cout << "Decomposed Unsound: " << Counts.DecomposedUnsound << "\n";
+    }
+    if (Options.Soundness) {
+        std::cout << "Composite Unsound: " << Counts.CompositeUnsound << "\n";
+        std::cout << "Decomposed Unsound: " << Counts.DecomposedUnsound << "\n";
+    }
+    if (Options.Distance) {
+        for (unsigned Bin = 0; Bin < array_lengthof(Counts.DistanceBins); ++Bin) {
+            if (Counts.DistanceBins[Bin] != 0)
+                std::cout << "Precision Distance " << int(Bin) - int(MaxExhaustiveBitWidth) << ": "
+                          << Counts.DistanceBins[Bin] << "\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+// Versions of the checkpoint, --incremental cache and shard file formats. Bump
+// them whenever the counters or the lines around them change, so that files
+// written by other builds are refused with a clear error.
+static const char *const CheckpointVersion = "v2";
+static const char *const CacheVersion = "v2";
+static const char *const ShardVersion = "v2";
+
+// Function to name a configuration in checkpoint and shard files
+static std::string getConfigKey(StringRef Name, unsigned BitWidth, unsigned Param) {
+    return Name.str() + " " + std::to_string(BitWidth) + " " + std::to_string(Param);
+}
+
+// Function to describe the options that affect the counts, so that checkpoint
+// and shard files of one run are not mixed with those of another
+static std::string getRunSignature() {
+    std::string Signature = "ops=";
+    for (const std::string &Name : Options.OperationNames)
+        Signature += Name + ",";
+    Signature += " bitwidths=" + std::to_string(Options.MinBitWidth) + "-" + std::to_string(Options.MaxBitWidth);
+    for (const std::pair<unsigned, unsigned> &Range : Options.ParamRanges)
+        Signature += (&Range == &Options.ParamRanges.front() ? " params=" : ",") + std::to_string(Range.first) + "-" +
+                     std::to_string(Range.second);
+    Signature += " backend=" + std::to_string(unsigned(Options.SelectedBackend));
+    Signature += std::string(" flags=") + (Options.CrossCheck ? "c" : "") + (Options.Differential ? "d" : "") +
+                 (Options.Optimal ? "o" : "") + (Options.Distance ? "h" : "") +
+                 (Options.Soundness ? "s" : "") + (Options.Library ? "l" : "");
+    return Signature;
+}
+
+// Function to format the counters as space-separated decimals, each preceded
+// by a space, then the nonzero bins of the distance histogram as
+// <distance>:<count>
+static std::string formatCounters(PrecisionCounts Counts) {
+    std::string Text;
+    Counts.forEachCounter([&](uint64_t &Counter) { Text += " " + std::to_string(Counter); });
+    for (unsigned Bin = 0; Bin < array_lengthof(Counts.DistanceBins); ++Bin) {
+        if (Counts.DistanceBins[Bin] != 0)
+            Text += " " + std::to_string(int(Bin) - int(MaxExhaustiveBitWidth)) + ":" +
+                    std::to_string(Counts.DistanceBins[Bin]);
+    }
+    return Text;
+}
+
+// Function to read counters written by formatCounters, up to the end of In
+static bool readCounters(std::istream &In, PrecisionCounts &Counts) {
+    Counts.forEachCounter([&](uint64_t &Counter) { In >> Counter; });
+    if (!In)
+        return false;
+    std::string Token;
+    while (In >> Token) {
+        std::pair<StringRef, StringRef> Split = StringRef(Token).split(':');
+        int Distance;
+        uint64_t Count;
+        if (Split.first.getAsInteger(10, Distance) || Split.second.getAsInteger(10, Count) ||
+            Distance < -int(MaxExhaustiveBitWidth) || Distance > int(MaxExhaustiveBitWidth))
+            return false;
+        Counts.recordDistance(Distance, Count);
+    }
+    return true;
+}
+
+// Function to report the counts of a configuration, readably or, for a shard,
+// as a line for --merge
+static void reportPrecisionCounts(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                                  const PrecisionCounts &Counts, double WallSeconds) {
+    if (Options.ShardCount != 0)
+        std::cout << "counts " << getConfigKey(Op.Name, BitWidth, Param) << formatCounters(Counts) << "\n";
+    else
+        printPrecisionCounts(Op, BitWidth, Param, Counts, Counts.TotalComparisons, WallSeconds);
+}
+
+// Function to get the seconds elapsed since Start
+static double getSecondsSince(std::chrono::steady_clock::time_point Start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+// Function to get the range of [0, NumItems) swept by this shard. Whole chunks
+// are dealt out in contiguous runs whose lengths differ by at most one, so the
+// partition depends only on the shard numbers.
+static std::pair<uint64_t, uint64_t> getShardRange(uint64_t NumItems, uint64_t ChunkSize) {
+    if (Options.ShardCount == 0)
+        return {0, NumItems};
+    uint64_t NumChunks = (NumItems + ChunkSize - 1) / ChunkSize;
+    uint64_t Base = NumChunks / Options.ShardCount, Extra = NumChunks % Options.ShardCount;
+    auto chunkStart = [&](uint64_t Shard) {
+        return std::min(NumItems, (Shard * Base + std::min<uint64_t>(Shard, Extra)) * ChunkSize);
+    };
+    return {chunkStart(Options.ShardIndex), chunkStart(Options.ShardIndex + 1)};
+}
+
+// File of per-input precision orders written by --store and read by --diff.
+// A StoreHeader is followed by one StoreEntry per configuration and then by the
+// packed orders of each configuration (see storePrecisionOrder), each starting
+// on a 64-byte boundary. The file is mapped, so a diff reads only the pages of
+// the configurations it compares.
+struct StoreHeader {
+    char Magic[8];
+    uint64_t NumConfigs;
+};
+
+struct StoreEntry {
+    char Name[32];
+    uint32_t BitWidth;
+    uint32_t Param;
+    uint64_t NumValues;
+    uint64_t Offset;
+};
+
+static const char StoreMagic[8] = {'K', 'B', 'O', 'R', 'D', 'E', 'R', '1'};
+
+class PrecisionOrderStore {
+public:
+    // Function to create Path with room for the configurations in Entries, whose
+    // offsets are filled in, and map it for writing. The orders start zeroed.
+    bool create(const std::string &Path, std::vector<StoreEntry> Entries) {
+        uint64_t Size = alignTo(sizeof(StoreHeader) + Entries.size() * sizeof(StoreEntry), 64);
+        for (StoreEntry &Entry : Entries) {
+            Entry.Offset = Size;
+            Size += alignTo(divideCeil(Entry.NumValues, 4), 64);
+        }
+        int FD;
+        std::error_code EC = sys::fs::openFileForReadWrite(Path, FD, sys::fs::CD_CreateAlways, sys::fs::OF_None);
+        if (!EC)
+            EC = sys::fs::resize_file(FD, Size);
+        if (!EC)
+            map(FD, sys::fs::mapped_file_region::readwrite, Size, EC);
+        if (EC) {
+            errs() << "error: cannot create store " << Path << ": " << EC.message() << "\n";
+            return false;
+        }
+        StoreHeader Header;
+        std::copy(std::begin(StoreMagic), std::end(StoreMagic), Header.Magic);
+        Header.NumConfigs = Entries.size();
+        std::memcpy(Region.data(), &Header, sizeof(Header));
+        std::memcpy(Region.data() + sizeof(Header), Entries.data(), Entries.size() * sizeof(StoreEntry));
+        return true;
+    }
+
+    // Function to map an existing store read-only
+    bool open(const std::string &Path) {
+        int FD;
+        uint64_t Size = 0;
+        std::error_code EC = sys::fs::file_size(Path, Size);
+        if (!EC)
+            EC = sys::fs::openFileForRead(Path, FD);
+        if (!EC)
+            map(FD, sys::fs::mapped_file_region::readonly, Size, EC);
+        if (EC) {
+            errs() << "error: cannot open store " << Path << ": " << EC.message() << "\n";
+            return false;
+        }
+        StoreHeader Header;
+        if (Size < sizeof(Header) || (std::memcpy(&Header, Region.const_data(), sizeof(Header)),
+                                      !std::equal(std::begin(StoreMagic), std::end(StoreMagic), Header.Magic)) ||
+            Size < sizeof(Header) + Header.NumConfigs * sizeof(StoreEntry)) {
+            errs() << "error: " << Path << " is not a precision order store\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Function to find the packed orders of a configuration, null if it is not stored
+    const uint8_t *find(StringRef Name, unsigned BitWidth, unsigned Param, uint64_t NumValues) const {
+        uint64_t Offset = findOffset(Name, BitWidth, Param, NumValues);
+        return Offset ? reinterpret_cast<const uint8_t *>(Region.const_data()) + Offset : nullptr;
+    }
+
+    // Function to find the packed orders of a configuration in a created store
+    uint8_t *findForWriting(StringRef Name, unsigned BitWidth, unsigned Param, uint64_t NumValues) {
+        uint64_t Offset = findOffset(Name, BitWidth, Param, NumValues);
+        return Offset ? reinterpret_cast<uint8_t *>(Region.data()) + Offset : nullptr;
+    }
+
+private:
+    // Function to get the offset of a configuration's orders, 0 if it is not stored
+    uint64_t findOffset(StringRef Name, unsigned BitWidth, unsigned Param, uint64_t NumValues) const {
+        if (!Region)
+            return 0;
+        StoreHeader Header;
+        std::memcpy(&Header, Region.const_data(), sizeof(Header));
+        for (uint64_t i = 0; i < Header.NumConfigs; ++i) {
+            StoreEntry Entry;
+            std::memcpy(&Entry, Region.const_data() + sizeof(Header) + i * sizeof(StoreEntry), sizeof(Entry));
+            Entry.Name[sizeof(Entry.Name) - 1] = '\0';
+            if (Name == Entry.Name && Entry.BitWidth == BitWidth && Entry.Param == Param &&
+                Entry.NumValues == NumValues && Entry.Offset + divideCeil(NumValues, 4) <= Region.size())
+                return Entry.Offset;
+        }
+        return 0;
+    }
+
+    // Function to map the open file FD and close it
+    void map(int FD, sys::fs::mapped_file_region::mapmode Mode, uint64_t Size, std::error_code &EC) {
+        sys::fs::file_t File = sys::fs::convertFDToNativeFile(FD);
+        Region = sys::fs::mapped_file_region(File, Mode, Size, 0, EC);
+        sys::fs::closeFile(File);
+    }
+
+    sys::fs::mapped_file_region Region;
+};
+
+static PrecisionOrderStore ResultStore, BaselineStore;
+
+// Function to count the inputs whose packed orders differ between two stores
+static uint64_t countOrderMismatches(const uint8_t *Baseline, const uint8_t *Orders, uint64_t NumValues) {
+    uint64_t Mismatches = 0;
+    for (uint64_t i = 0, E = divideCeil(NumValues, 4); i < E; ++i) {
+        unsigned Diff = Baseline[i] ^ Orders[i];
+        Mismatches += countPopulation((Diff | (Diff >> 1)) & 0x55u);
+    }
+    return Mismatches;
+}
+
+// Number of chunks per worker between the barriers of a checkpointed sweep. The
+// barrier idles each worker for at most one chunk, so the cost stays well
+// below 1% at this length.
+static const uint64_t CheckpointEpochChunks = 1024;
+
+// Progress of a run saved by --checkpoint: the counters of every finished
+// configuration and of the one in progress, whose sweep is complete below a
+// frontier index. The file is text, one configuration per line,
+//   done <op> <BitWidth> <Param> <counters...>
+//   partial <op> <BitWidth> <Param> <frontier> <counters...>
+// after a header naming the options that affect the counts, so that a run with
+// other options does not resume from it. Saves go through a temporary file that
+// is renamed over the checkpoint, so a kill never leaves a truncated one.
+class SweepCheckpoint {
+public:
+    bool enabled() const { return !Path.empty(); }
+
+    void open(const std::string &CheckpointPath, unsigned IntervalSeconds) {
+        Path = CheckpointPath;
+        Interval = std::chrono::seconds(IntervalSeconds);
+        LastSave = std::chrono::steady_clock::now();
+    }
+
+    // Function to read the checkpoint for --resume. A missing file starts the run
+    // afresh. Returns false if the file belongs to another run or is malformed.
+    bool load() {
+        std::ifstream In(Path);
+        if (!In)
+            return true;
+        std::string Line;
+        if (!std::getline(In, Line) || Line != header()) {
+            std::string Tag, Version;
+            std::istringstream(Line) >> Tag >> Version;
+            if (Tag == "checkpoint" && Version != CheckpointVersion)
+                errs() << "error: " << Path << " is a checkpoint of format " << Version << ", this build reads "
+                       << CheckpointVersion << "\n";
+            else
+                errs() << "error: " << Path << " is not a checkpoint of this run\n";
+            return false;
+        }
+        while (std::getline(In, Line)) {
+            std::istringstream Fields(Line);
+            std::string Kind, Name;
+            unsigned BitWidth, Param;
+            uint64_t Frontier = 0;
+            PrecisionCounts Counts;
+            Fields >> Kind >> Name >> BitWidth >> Param;
+            if (Kind == "partial")
+                Fields >> Frontier;
+            if (!readCounters(Fields, Counts) || (Kind != "done" && Kind != "partial")) {
+                errs() << "error: malformed checkpoint line '" << Line << "' in " << Path << "\n";
+                return false;
+            }
+            std::string Config = getConfigKey(Name, BitWidth, Param);
+            if (Kind == "done") {
+                Done.push_back({Config, Counts});
+            } else {
+                PartialConfig = Config;
+                PartialFrontier = Frontier;
+                PartialCounts = Counts;
+            }
+        }
+        return true;
+    }
+
+    // Function to get the counters of a configuration finished before the resume
+    bool findDone(const std::string &Config, PrecisionCounts &Counts) const {
+        for (const std::pair<std::string, PrecisionCounts> &Entry : Done) {
+            if (Entry.first == Config) {
+                Counts = Entry.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Function to get the frontier and counters of the configuration that was in
+    // progress
+    bool findPartial(const std::string &Config, uint64_t &Frontier, PrecisionCounts &Counts) const {
+        if (Config != PartialConfig)
+            return false;
+        Frontier = PartialFrontier;
+        Counts = PartialCounts;
+        return true;
+    }
+
+    // Function to record that Config is swept below Frontier, saving if the
+    // interval has passed since the last save
+    void recordProgress(const std::string &Config, uint64_t Frontier, const PrecisionCounts &Counts) {
+        PartialConfig = Config;
+        PartialFrontier = Frontier;
+        PartialCounts = Counts;
+        saveIfDue();
+    }
+
+    // Function to record that Config is finished
+    void recordDone(const std::string &Config, const PrecisionCounts &Counts) {
+        if (Config == PartialConfig)
+            PartialConfig.clear();
+        Done.push_back({Config, Counts});
+        saveIfDue();
+    }
+
+    void save() {
+        std::string TempPath = Path + ".tmp";
+        {
+            std::ofstream Out(TempPath, std::ios::trunc);
+            Out << header() << "\n";
+            for (const std::pair<std::string, PrecisionCounts> &Entry : Done)
+                Out << "done " << Entry.first << formatCounters(Entry.second) << "\n";
+            if (!PartialConfig.empty())
+                Out << "partial " << PartialConfig << " " << PartialFrontier << formatCounters(PartialCounts) << "\n";
+            if (!Out.flush()) {
+                errs() << "warning: cannot write checkpoint " << TempPath << "\n";
+                return;
+            }
+        }
+        if (std::rename(TempPath.c_str(), Path.c_str()) != 0)
+            errs() << "warning: cannot replace checkpoint " << Path << "\n";
+        LastSave = std::chrono::steady_clock::now();
+    }
+
+private:
+    void saveIfDue() {
+        if (std::chrono::steady_clock::now() - LastSave >= Interval)
+            save();
+    }
+
+    // Header line identifying the run, including the shard it sweeps
+    static std::string header() {
+        return std::string("checkpoint ") + CheckpointVersion + " " + getRunSignature() + " shard=" + std::to_string(Options.ShardIndex) + "/" +
+               std::to_string(Options.ShardCount);
+    }
+
+    std::string Path;
+    std::chrono::steady_clock::duration Interval;
+    std::chrono::steady_clock::time_point LastSave;
+    std::vector<std::pair<std::string, PrecisionCounts>> Done;
+    std::string PartialConfig;
+    uint64_t PartialFrontier = 0;
+    PrecisionCounts PartialCounts;
+};
+
+static SweepCheckpoint Checkpoint;
+
+// Number of probe inputs (operand pairs for binary operations) a fingerprint
+// evaluates. Configurations with at most this many inputs are probed in full.
+static const uint64_t MaxFingerprintProbes = 4096;
+
+// FNV-1a over 64-bit words, stable across runs and builds
+struct FingerprintHasher {
+    uint64_t Hash = 0xcbf29ce484222325ULL;
+
+    void add(uint64_t Word) {
+        for (unsigned Byte = 0; Byte < 8; ++Byte, Word >>= 8)
+            Hash = (Hash ^ (Word & 0xff)) * 0x100000001b3ULL;
+    }
+    void add(StringRef Text) {
+        for (unsigned char C : Text)
+            add(uint64_t(C));
+    }
+    void add(const KnownBits &KBInstance) {
+        add(KBInstance.Zero.getZExtValue());
+        add(KBInstance.One.getZExtValue());
+    }
+};
+
+// Function to fingerprint a configuration for --incremental. Source is not
+// visible at run time, so the fingerprint hashes what stands in for it: the
+// operation's Revision, the LLVM version, the backend and checks of the run,
+// and both results of the APInt functions on the probe inputs. Editing a
+// function without a Revision bump is noticed if it changes a probe result.
+uint64_t getFingerprint(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param) {
+    FingerprintHasher Hasher;
+    Hasher.add(Op.Name);
+    Hasher.add(Op.Revision);
+    Hasher.add(StringRef(LLVM_VERSION_STRING));
+    Hasher.add(uint64_t(Options.SelectedBackend));
+    Hasher.add(Options.CrossCheck + 2 * Options.Differential + 4 * Options.Optimal + 8 * Options.Distance +
+               16 * Options.Soundness + 32 * Options.Library);
+    Hasher.add(BitWidth);
+    Hasher.add(Param);
+
+    // Probes are every input when they fit, or else a fixed uniform sample
+    uint64_t NumValues = numAbstractValues(BitWidth);
+    bool Exhaustive = Op.Arity == 1 ? NumValues <= MaxFingerprintProbes
+                                    : NumValues <= MaxFingerprintProbes / NumValues;
+    uint64_t NumProbes = Exhaustive ? (Op.Arity == 1 ? NumValues : NumValues * NumValues) : MaxFingerprintProbes;
+    RandomBits Random(0x5eedULL ^ (uint64_t(BitWidth) << 32) ^ Param);
+    KnownBits Operands[2] = {KnownBits(BitWidth), KnownBits(BitWidth)};
+    KnownBits CompositeResult(BitWidth), DecomposedResult(BitWidth);
+    for (uint64_t Probe = 0; Probe < NumProbes; ++Probe) {
+        if (!Exhaustive) {
+            sampleUniform(Random, Operands, Op.Arity);
+        } else if (Op.Arity == 1) {
+            decodeKnownBits(Probe, Operands[0]);
+        } else {
+            decodeKnownBits(Probe / NumValues, Operands[0]);
+            decodeKnownBits(Probe % NumValues, Operands[1]);
+        }
+        if (Op.Arity == 1) {
+            Op.CompositeInto(Operands[0], Param, CompositeResult);
+            Op.DecomposedInto(Operands[0], Param, DecomposedResult);
+            Hasher.add(CompositeResult);
+            Hasher.add(DecomposedResult);
+        } else {
+            Hasher.add(Op.CompositeBinary(Operands[0], Operands[1]));
+            Hasher.add(Op.DecomposedBinary(Operands[0], Operands[1]));
+        }
+    }
+    return Hasher.Hash;
+}
+
+// Counters of earlier runs kept by --incremental, by configuration with the
+// fingerprint they were computed under. The file is text, after a header line,
+//   cell <op> <BitWidth> <Param> <fingerprint> <counters...>
+// and is rewritten, through a temporary file, as each configuration finishes.
+class VerificationCache {
+public:
+    bool enabled() const { return !Path.empty(); }
+
+    // Function to read the cache at CachePath. A missing file starts an empty
+    // cache. Returns false if the file is malformed.
+    bool load(const std::string &CachePath) {
+        Path = CachePath;
+        std::ifstream In(Path);
+        if (!In)
+            return true;
+        std::string Line;
+        if (!std::getline(In, Line) || Line != std::string("incremental ") + CacheVersion) {
+            if (StringRef(Line).startswith("incremental "))
+                errs() << "error: " << Path << " is an incremental cache of format " << Line.substr(12)
+                       << ", this build reads " << CacheVersion << "\n";
+            else
+                errs() << "error: " << Path << " is not an incremental cache\n";
+            return false;
+        }
+        while (std::getline(In, Line)) {
+            std::istringstream Fields(Line);
+            std::string Kind, Name;
+            unsigned BitWidth, Param;
+            uint64_t Fingerprint;
+            PrecisionCounts Counts;
+            Fields >> Kind >> Name >> BitWidth >> Param >> std::hex >> Fingerprint >> std::dec;
+            if (Kind != "cell" || !readCounters(Fields, Counts)) {
+                errs() << "error: malformed cache line '" << Line << "' in " << Path << "\n";
+                return false;
+            }
+            Cells[getConfigKey(Name, BitWidth, Param)] = {Fingerprint, Counts};
+        }
+        return true;
+    }
+
+    // Function to get the counters of Config if they were computed under Fingerprint
+    bool find(const std::string &Config, uint64_t Fingerprint, PrecisionCounts &Counts) {
+        std::map<std::string, std::pair<uint64_t, PrecisionCounts>>::const_iterator It = Cells.find(Config);
+        if (It == Cells.end() || It->second.first != Fingerprint)
+            return false;
+        Counts = It->second.second;
+        ++NumReused;
+        return true;
+    }
+
+    // Function to record the counters of Config and save the cache
+    void record(const std::string &Config, uint64_t Fingerprint, const PrecisionCounts &Counts) {
+        Cells[Config] = {Fingerprint, Counts};
+        std::string TempPath = Path + ".tmp";
+        {
+            std::ofstream Out(TempPath, std::ios::trunc);
+            Out << "incremental " << CacheVersion << "\n";
+            for (const auto &Cell : Cells)
+                Out << "cell " << Cell.first << " " << std::hex << Cell.second.first << std::dec
+                    << formatCounters(Cell.second.second) << "\n";
+            if (!Out.flush()) {
+                errs() << "warning: cannot write cache " << TempPath << "\n";
+                return;
+            }
+        }
+        if (std::rename(TempPath.c_str(), Path.c_str()) != 0)
+            errs() << "warning: cannot replace cache " << Path << "\n";
+    }
+
+    unsigned getNumReused() const { return NumReused; }
+
+private:
+    std::string Path;
+    std::map<std::string, std::pair<uint64_t, PrecisionCounts>> Cells;
+    unsigned NumReused = 0;
+};
+
+static VerificationCache Cache;
+
+// Function to derive a unary configuration from the input bits its functions
+// read, see sweepGeneralized. Returns false, having printed nothing, if the
+// functions read every bit or the other bits turn out to matter, in which case
+// the configuration needs full enumeration.
+bool testGeneralized(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param) {
+    std::pair<unsigned, unsigned> Support = Op.Support(BitWidth, Param);
+    unsigned Lo = Support.first, Hi = Support.second;
+    assert(Lo < Hi && Hi <= BitWidth && "Invalid support");
+    if (Hi - Lo == BitWidth)
+        return false;
+
+    // With the support at the low bits, the inputs whose other digits are all
+    // unknown are the last 3^(Hi - Lo) abstract values, so the fixed-width
+    // backends can count them with their ordinary sweeps
+    uint64_t NumItems = numAbstractValues(Hi - Lo);
+    uint64_t Offset = numAbstractValues(BitWidth) - NumItems;
+    bool BackendCounts = Lo == 0 && Options.SelectedBackend != Backend::APInt;
+    const FixedSweepTable *Sweeps =
+        Options.SelectedBackend == Backend::Batched ? Op.BatchedSweeps : Op.ScalarSweeps;
+    SweepContext Context;
+    Context.Param = Param;
+    uint64_t CheckStride = std::max<uint64_t>(1, NumItems / MaxSupportChecks);
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    std::atomic<bool> InvariantHolds(true);
+    std::vector<PrecisionCounts> WorkerCounts(Pool.getThreadCount());
+    parallelForChunks(Pool, NumItems, SweepChunkSize, [&](unsigned Worker, uint64_t Begin, uint64_t End) {
+        if (BackendCounts)
+            (*Sweeps)[BitWidth - 1](Context, Offset + Begin, Offset + End, WorkerCounts[Worker]);
+        sweepGeneralized(Op, BitWidth, Param, Lo, Hi, Begin, End, CheckStride, !BackendCounts,
+                         WorkerCounts[Worker], InvariantHolds);
+    });
+    if (!InvariantHolds) {
+        errs() << "warning: " << Op.Name << " at BitWidth " << BitWidth << ", " << getParamName(Op.Param)
+               << " " << Param << " reads input bits outside [" << Lo << ", " << Hi
+               << "), enumerating in full\n";
+        return false;
+    }
+
+    PrecisionCounts Counts;
+    for (const PrecisionCounts &Partial : WorkerCounts)
+        Counts += Partial;
+    Counts.scale(numAbstractValues(BitWidth - (Hi - Lo)));
+    printPrecisionCounts(Op, BitWidth, Param, Counts, NumItems, getSecondsSince(Start));
+    return true;
+}
+
+// Function to report a unary configuration swept by unknown-bit mask, see
+// sweepGroupedByMask. Returns false, having printed nothing, if some class
+// compares differently across its fills and must be enumerated in full.
+bool testGroupedByMask(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param) {
+    uint64_t NumMasks = uint64_t(1) << BitWidth;
+    uint64_t CheckStride = std::max<uint64_t>(1, NumMasks / MaxMaskChecks);
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    std::atomic<bool> InvariantHolds(true);
+    std::vector<PrecisionCounts> WorkerCounts(Pool.getThreadCount());
+    std::vector<uint64_t> WorkerEvaluated(Pool.getThreadCount());
+    parallelForChunks(Pool, NumMasks, SweepChunkSize, [&](unsigned Worker, uint64_t Begin, uint64_t End) {
+        sweepGroupedByMask(Op, BitWidth, Param, Begin, End, CheckStride, WorkerCounts[Worker],
+                           WorkerEvaluated[Worker], InvariantHolds);
+    });
+    if (!InvariantHolds) {
+        errs() << "warning: " << Op.Name << " at BitWidth " << BitWidth << ", " << getParamName(Op.Param)
+               << " " << Param << " compares differently within an unknown-bit mask, enumerating in full\n";
+        return false;
+    }
+
+    PrecisionCounts Counts;
+    uint64_t Evaluated = 0;
+    for (unsigned Worker = 0; Worker < WorkerCounts.size(); ++Worker) {
+        Counts += WorkerCounts[Worker];
+        Evaluated += WorkerEvaluated[Worker];
+    }
+    printPrecisionCounts(Op, BitWidth, Param, Counts, Evaluated, getSecondsSince(Start));
+    return true;
+}
+
+// Function to sweep the items [Begin, End) of a configuration on the selected
+// backend: abstract values for unary operations, tiles for binary ones
+void sweepItems(const TransferFunctionInfo &Op, unsigned BitWidth, const SweepContext &Context, uint64_t Begin,
+                uint64_t End, PrecisionCounts &Counts) {
+    if (Options.SelectedBackend == Backend::Fixed)
+        (*Op.ScalarSweeps)[BitWidth - 1](Context, Begin, End, Counts);
+    else if (Options.SelectedBackend == Backend::Batched)
+        (*Op.BatchedSweeps)[BitWidth - 1](Context, Begin, End, Counts);
+    else if (Op.Arity == 2)
+        sweepBinaryAPInt(Op, BitWidth, Context, Begin, End, Counts);
+    else
+        sweepAPInt(Op, BitWidth, Context, Begin, End, Counts);
+}
+
+#ifdef VERIFY_WITH_CUDA
+// Function to sweep the abstract values [Begin, End) of a unary configuration on
+// the GPU, see sweep_gpu.cu, adding to Counts. A failed sweep leaves nothing to
+// report, so it ends the run with an error.
+// With --differential, GPUOrders and FixedOrders hold the packed orders of the
+// whole configuration (see storePrecisionOrder). The range is then also swept on
+// the fixed backend, and every input whose orders differ counts as a backend
+// mismatch, as do the fixed backend's own mismatches against the APInt functions.
+void sweepGPU(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param, uint64_t Begin,
+              uint64_t End, uint8_t *GPUOrders, uint8_t *FixedOrders, PrecisionCounts &Counts) {
+    // Sweeps start at chunk boundaries, so their orders start at a whole byte
+    assert(Begin % 4 == 0 && "Sweep does not start at a byte of packed orders");
+    uint64_t OrderCounts[4] = {};
+    char Error[256];
+    if (sweepUnaryOnGPU(Op.Name, BitWidth, Param, Begin, End, OrderCounts, GPUOrders ? GPUOrders + Begin / 4 : nullptr,
+                        Error, sizeof(Error)) != 0) {
+        errs() << "error: " << Error << "\n";
+        exit(1);
+    }
+    static const PrecisionOrder Orders[] = {PrecisionOrder::Equal, PrecisionOrder::FirstMorePrecise,
+                                            PrecisionOrder::SecondMorePrecise, PrecisionOrder::Incomparable};
+    for (unsigned i = 0; i < array_lengthof(Orders); ++i)
+        Counts.record(Orders[i], OrderCounts[i]);
+    if (!GPUOrders)
+        return;
+
+    SweepContext Context;
+    Context.Param = Param;
+    Context.Orders = FixedOrders;
+    std::vector<PrecisionCounts> WorkerCounts(Pool.getThreadCount());
+    parallelForChunks(Pool, End - Begin, SweepChunkSize, [&](unsigned Worker, uint64_t ChunkBegin, uint64_t ChunkEnd) {
+        (*Op.ScalarSweeps)[BitWidth - 1](Context, Begin + ChunkBegin, Begin + ChunkEnd, WorkerCounts[Worker]);
+    });
+    for (const PrecisionCounts &Partial : WorkerCounts)
+        Counts.BackendMismatches += Partial.BackendMismatches;
+    Counts.BackendMismatches += countOrderMismatches(FixedOrders + Begin / 4, GPUOrders + Begin / 4, End - Begin);
+}
+#endif
+
+// Function to compare the composite and decomposed transfer functions of Op.
+// Domain is the tabulated abstract domain of BitWidth, or null if it is not
+// tabulated. Returns true if the configuration was enumerated in full.
+bool testTransferFunctions(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                           const AbstractDomainTable *Domain) {
+    if (Options.Generalize && Op.Support && testGeneralized(Pool, Op, BitWidth, Param))
+        return false;
+    if (Options.GroupByMask && Op.MaskDetermined && testGroupedByMask(Pool, Op, BitWidth, Param))
+        return false;
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    // A configuration whose fingerprint is unchanged since it was cached, or
+    // that finished before a resume, is reported from the cache or checkpoint
+    std::string Config = getConfigKey(Op.Name, BitWidth, Param);
+    PrecisionCounts Counts;
+    uint64_t Fingerprint = Cache.enabled() ? getFingerprint(Op, BitWidth, Param) : 0;
+    if (Cache.enabled() && Cache.find(Config, Fingerprint, Counts)) {
+        reportPrecisionCounts(Op, BitWidth, Param, Counts, -1);
+        return true;
+    }
+    if (Checkpoint.enabled() && Checkpoint.findDone(Config, Counts)) {
+        reportPrecisionCounts(Op, BitWidth, Param, Counts, -1);
+        return true;
+    }
+
+    // Unary operations are swept over abstract values and binary ones over tiles
+    // of operand pairs, one tile per chunk
+    bool Binary = Op.Arity == 2;
+    uint64_t NumItems = Binary ? numBinaryTilesPerSide(BitWidth) * numBinaryTilesPerSide(BitWidth)
+                               : numAbstractValues(BitWidth);
+    uint64_t ChunkSize = Binary ? 1 : SweepChunkSize;
+
+    SweepContext Context;
+    Context.Param = Param;
+    std::vector<uint64_t> ConcreteResults, OptimalZero, OptimalOne;
+    if (Options.Optimal || Options.Soundness) {
+        ConcreteResults = buildConcreteTable(Pool, Op, BitWidth, Param);
+        Context.ConcreteResults = ConcreteResults.data();
+        if (Domain && !Binary) {
+            buildOptimalTable(*Domain, ConcreteResults, OptimalZero, OptimalOne);
+            Context.OptimalZero = OptimalZero.data();
+            Context.OptimalOne = OptimalOne.data();
+        }
+    }
+
+    // With --store or --diff the order of every unary input is kept, in the
+    // store or, when only diffing, in memory
+    std::vector<uint8_t> Orders;
+    const uint8_t *Baseline = nullptr;
+    if (!Binary && !Options.StorePath.empty())
+        Context.Orders = ResultStore.findForWriting(Op.Name, BitWidth, Param, NumItems);
+    if (!Binary && !Options.DiffPath.empty()) {
+        Baseline = BaselineStore.find(Op.Name, BitWidth, Param, NumItems);
+        if (!Baseline)
+            errs() << "warning: " << Config << " is not in the store " << Options.DiffPath << "\n";
+        else if (!Context.Orders) {
+            Orders.resize(divideCeil(NumItems, 4));
+            Context.Orders = Orders.data();
+        }
+    }
+
+    // Items of the shard below the frontier are swept and counted in Counts.
+    // Without a checkpoint the whole shard is one step; with one, every step
+    // ends at a barrier where the frontier and counters are saved when due.
+    std::pair<uint64_t, uint64_t> Shard = getShardRange(NumItems, ChunkSize);
+    uint64_t Frontier = Shard.first;
+    uint64_t StepItems = NumItems;
+    if (Checkpoint.enabled()) {
+        Checkpoint.findPartial(Config, Frontier, Counts);
+        StepItems = CheckpointEpochChunks * ChunkSize * Pool.getThreadCount();
+    }
+    // With --differential the gpu backend keeps the orders of both backends, see sweepGPU
+    std::vector<uint8_t> GPUOrders, FixedOrders;
+    if (Options.SelectedBackend == Backend::GPU && Options.Differential) {
+        GPUOrders.resize(divideCeil(NumItems, 4));
+        FixedOrders.resize(divideCeil(NumItems, 4));
+    }
+    while (Frontier < Shard.second) {
+        uint64_t StepEnd = std::min(Shard.second, Frontier + StepItems);
+#ifdef VERIFY_WITH_CUDA
+        if (Options.SelectedBackend == Backend::GPU) {
+            sweepGPU(Pool, Op, BitWidth, Param, Frontier, StepEnd, GPUOrders.empty() ? nullptr : GPUOrders.data(),
+                     FixedOrders.empty() ? nullptr : FixedOrders.data(), Counts);
+            Frontier = StepEnd;
+            if (Checkpoint.enabled() && Frontier < Shard.second)
+                Checkpoint.recordProgress(Config, Frontier, Counts);
+            continue;
+        }
+#endif
+        std::vector<PrecisionCounts> WorkerCounts(Pool.getThreadCount());
+        parallelForChunks(Pool, StepEnd - Frontier, ChunkSize, [&](unsigned Worker, uint64_t Begin, uint64_t End) {
+            sweepItems(Op, BitWidth, Context, Frontier + Begin, Frontier + End, WorkerCounts[Worker]);
+        });
+        for (const PrecisionCounts &Partial : WorkerCounts)
+            Counts += Partial;
+        Frontier = StepEnd;
+        if (Checkpoint.enabled() && Frontier < Shard.second)
+            Checkpoint.recordProgress(Config, Frontier, Counts);
+    }
+    if (Checkpoint.enabled())
+        Checkpoint.recordDone(Config, Counts);
+    if (Baseline)
+        Counts.StoreMismatches = countOrderMismatches(Baseline, Context.Orders, NumItems);
+    if (Cache.enabled())
+        Cache.record(Config, Fingerprint, Counts);
+
+    reportPrecisionCounts(Op, BitWidth, Param, Counts, getSecondsSince(Start));
+    return true;
+}
+
+// The grid scheduler (--schedule grid) sweeps every configuration of a run in one
+// parallel region rather than one region per configuration, so small
+// configurations fill the gaps that large ones leave at their end. Each worker
+// has a deque of tasks, ranges of a configuration's items. Configurations are
+// dealt out largest first, each to the worker with the least work so far. A
+// worker takes the task at the front of its own deque and halves it, pushing the
+// upper half back to the front, until at most two chunks remain, which it sweeps.
+// Chunk sizes thereby adapt to the work left: an idle worker steals from the back
+// of another worker's deque, where the largest ranges are, and halves them in
+// turn. Reports are printed in the usual order once the grid is done.
+
+// One configuration of the grid and the counters of its finished tasks
+struct GridJob {
+    const TransferFunctionInfo *Op;
+    unsigned BitWidth, Param;
+    uint64_t NumItems, ChunkSize;
+    SweepContext Context;
+    std::mutex Lock;                   // Guards Counts
+    PrecisionCounts Counts;
+    std::atomic<uint64_t> RemainingItems;
+    std::atomic<int64_t> StartNanos;   // When its first task started, relative to the grid
+    int64_t EndNanos = 0;              // When its last task ended, set by the worker that ran it
+};
+
+// Items [Begin, End) of a grid job
+struct GridTask {
+    GridJob *Job;
+    uint64_t Begin, End;
+};
+
+// Tasks of one grid worker; the owner works at the front, thieves at the back
+struct GridQueue {
+    std::mutex Lock;
+    std::deque<GridTask> Tasks;
+};
+
+// Function to sweep every configuration of the run on the grid scheduler, see above
+bool runGrid(ThreadPool &Pool, const std::vector<const TransferFunctionInfo *> &Operations) {
+    std::deque<GridJob> Jobs;
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        for (const TransferFunctionInfo *Op : Operations) {
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth)) {
+                Jobs.emplace_back();
+                GridJob &Job = Jobs.back();
+                bool Binary = Op->Arity == 2;
+                Job.Op = Op;
+                Job.BitWidth = BitWidth;
+                Job.Param = Param;
+                Job.NumItems = Binary ? numBinaryTilesPerSide(BitWidth) * numBinaryTilesPerSide(BitWidth)
+                                      : numAbstractValues(BitWidth);
+                Job.ChunkSize = Binary ? 1 : SweepChunkSize;
+                Job.Context.Param = Param;
+                Job.RemainingItems = Job.NumItems;
+                Job.StartNanos = std::numeric_limits<int64_t>::max();
+            }
+        }
+    }
+
+    // Deal the jobs out largest first, a binary tile counting as its pairs
+    unsigned NumWorkers = Pool.getThreadCount();
+    std::vector<GridJob *> BySize;
+    for (GridJob &Job : Jobs)
+        BySize.push_back(&Job);
+    auto getCost = [](const GridJob *Job) {
+        return Job->NumItems * (Job->Op->Arity == 2 ? BinaryTileSize * BinaryTileSize : 1);
+    };
+    std::stable_sort(BySize.begin(), BySize.end(),
+                     [&](const GridJob *A, const GridJob *B) { return getCost(A) > getCost(B); });
+    std::vector<GridQueue> Queues(NumWorkers);
+    std::vector<uint64_t> Load(NumWorkers);
+    std::atomic<uint64_t> PendingItems(0);
+    for (GridJob *Job : BySize) {
+        unsigned Worker = std::min_element(Load.begin(), Load.end()) - Load.begin();
+        Load[Worker] += getCost(Job);
+        Queues[Worker].Tasks.push_back({Job, 0, Job->NumItems});
+        PendingItems += Job->NumItems;
+    }
+
+    // Function to take a task from the front of Worker's deque, or else from the
+    // back of the first other deque that has one
+    auto takeTask = [&](unsigned Worker, GridTask &Task) {
+        for (unsigned Offset = 0; Offset < NumWorkers; ++Offset) {
+            GridQueue &Queue = Queues[(Worker + Offset) % NumWorkers];
+            std::lock_guard<std::mutex> Guard(Queue.Lock);
+            if (Queue.Tasks.empty())
+                continue;
+            if (Offset == 0) {
+                Task = Queue.Tasks.front();
+                Queue.Tasks.pop_front();
+            } else {
+                Task = Queue.Tasks.back();
+                Queue.Tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    std::chrono::steady_clock::time_point GridStart = std::chrono::steady_clock::now();
+    auto getNanos = [&] {
+        return int64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                            GridStart).count());
+    };
+#ifdef VERIFY_STATS
+    std::vector<uint64_t> BusyNanos(NumWorkers);
+#endif
+    for (unsigned Worker = 0; Worker < NumWorkers; ++Worker) {
+        Pool.async([&, Worker] {
+            PrecisionCounts Partial;
+            while (PendingItems != 0) {
+                GridTask Task;
+                if (!takeTask(Worker, Task)) {
+                    // The work left is being swept by other workers
+                    std::this_thread::yield();
+                    continue;
+                }
+                GridJob &Job = *Task.Job;
+                while (Task.End - Task.Begin > 2 * Job.ChunkSize) {
+                    uint64_t Middle = Task.Begin + alignTo((Task.End - Task.Begin) / 2, Job.ChunkSize);
+                    std::lock_guard<std::mutex> Guard(Queues[Worker].Lock);
+                    Queues[Worker].Tasks.push_front({&Job, Middle, Task.End});
+                    Task.End = Middle;
+                }
+
+                int64_t Start = getNanos();
+                int64_t FirstStart = Job.StartNanos;
+                while (Start < FirstStart && !Job.StartNanos.compare_exchange_weak(FirstStart, Start))
+                    ;
+                Partial = PrecisionCounts();
+                sweepItems(*Job.Op, Job.BitWidth, Job.Context, Task.Begin, Task.End, Partial);
+                {
+                    std::lock_guard<std::mutex> Guard(Job.Lock);
+                    Job.Counts += Partial;
+                }
+                uint64_t NumItems = Task.End - Task.Begin;
+                int64_t End = getNanos();
+                if (Job.RemainingItems.fetch_sub(NumItems) == NumItems)
+                    Job.EndNanos = End;
+                PendingItems -= NumItems;
+#ifdef VERIFY_STATS
+                BusyNanos[Worker] += End - Start;
+#endif
+            }
+        });
+    }
+    Pool.wait();
+#ifdef VERIFY_STATS
+    uint64_t RegionNanos = getNanos();
+    VERIFY_STAT(ParallelRegions, 1);
+    for (unsigned Worker = 0; Worker < NumWorkers; ++Worker) {
+        unsigned Slot = std::min(Worker, MaxStatsWorkers - 1);
+        VERIFY_STAT(WorkerBusyNanos[Slot], BusyNanos[Worker]);
+        VERIFY_STAT(WorkerIdleNanos[Slot], RegionNanos - std::min(RegionNanos, BusyNanos[Worker]));
+    }
+#endif
+
+    // Each configuration's wall time runs from its first task to its last
+    for (GridJob &Job : Jobs)
+        reportPrecisionCounts(*Job.Op, Job.BitWidth, Job.Param, Job.Counts,
+                              (Job.EndNanos - Job.StartNanos) / 1e9);
+    return true;
+}
+
+#ifdef VERIFY_WITH_Z3
+// Symbolic backend. Each transfer function pair is encoded over symbolic Zero/One
+// bitvectors, and Z3 decides whether any conflict-free input makes one result
+// more precise than the other or the two incomparable. Each query takes
+// milliseconds at any bitwidth, where a sweep would take 3^W steps. The
+// encodings transliterate the APInt functions above and must change with them;
+// every witness is replayed through the APInt functions to catch drift.
+
+// Zero/One masks of a symbolic KnownBits value
+struct SymbolicKnownBits {
+    Z3_ast Zero;
+    Z3_ast One;
+};
+
+typedef SymbolicKnownBits (*SymbolicTransferFn)(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                                unsigned BitWidth, unsigned Param);
+
+// Symbolic encodings of a registered transfer function pair
+struct SymbolicTransferFunction {
+    const char *Name;
+    SymbolicTransferFn Composite;
+    SymbolicTransferFn Decomposed;
+};
+
+// Function to build a BitWidth-bit constant
+Z3_ast smtConstant(Z3_context Ctx, unsigned BitWidth, uint64_t Value) {
+    return Z3_mk_unsigned_int64(Ctx, Value, Z3_mk_bv_sort(Ctx, BitWidth));
+}
+
+// Function to build a BitWidth-bit value with the low Bits bits set
+Z3_ast smtLowBits(Z3_context Ctx, unsigned BitWidth, unsigned Bits) {
+    if (Bits == 0)
+        return smtConstant(Ctx, BitWidth, 0);
+    Z3_ast AllOnes = Z3_mk_bvnot(Ctx, smtConstant(Ctx, BitWidth, 0));
+    return Z3_mk_bvlshr(Ctx, AllOnes, smtConstant(Ctx, BitWidth, BitWidth - Bits));
+}
+
+// Functions to shift by a constant amount
+Z3_ast smtShl(Z3_context Ctx, Z3_ast Value, unsigned BitWidth, unsigned Amt) {
+    return Z3_mk_bvshl(Ctx, Value, smtConstant(Ctx, BitWidth, Amt));
+}
+Z3_ast smtLshr(Z3_context Ctx, Z3_ast Value, unsigned BitWidth, unsigned Amt) {
+    return Z3_mk_bvlshr(Ctx, Value, smtConstant(Ctx, BitWidth, Amt));
+}
+Z3_ast smtAshr(Z3_context Ctx, Z3_ast Value, unsigned BitWidth, unsigned Amt) {
+    return Z3_mk_bvashr(Ctx, Value, smtConstant(Ctx, BitWidth, Amt));
+}
+
+// Function to extract bit Bit of Value as a 1-bit vector
+Z3_ast smtBit(Z3_context Ctx, Z3_ast Value, unsigned Bit) {
+    return Z3_mk_extract(Ctx, Bit, Bit, Value);
+}
+
+// Function to assemble a bitvector from 1-bit vectors, Bits[0] being the lowest
+Z3_ast smtFromBits(Z3_context Ctx, const std::vector<Z3_ast> &Bits) {
+    Z3_ast Result = Bits[0];
+    for (unsigned i = 1; i < Bits.size(); ++i)
+        Result = Z3_mk_concat(Ctx, Bits[i], Result);
+    return Result;
+}
+
+// Function to test whether every bit set in A is set in B
+Z3_ast smtIsSubsetOf(Z3_context Ctx, Z3_ast A, Z3_ast B, unsigned BitWidth) {
+    return Z3_mk_eq(Ctx, Z3_mk_bvand(Ctx, A, Z3_mk_bvnot(Ctx, B)), smtConstant(Ctx, BitWidth, 0));
+}
+
+// Symbolic sextInRegComposite
+SymbolicKnownBits smtSextInRegComposite(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                        unsigned BitWidth, unsigned SrcBitWidth) {
+    if (SrcBitWidth == BitWidth)
+        return KBInstance;
+    unsigned ExtBits = BitWidth - SrcBitWidth;
+    return {smtAshr(Ctx, smtShl(Ctx, KBInstance.Zero, BitWidth, ExtBits), BitWidth, ExtBits),
+            smtAshr(Ctx, smtShl(Ctx, KBInstance.One, BitWidth, ExtBits), BitWidth, ExtBits)};
+}
+
+// Symbolic sextInRegDecomposed
+SymbolicKnownBits smtSextInRegDecomposed(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                         unsigned BitWidth, unsigned SrcBitWidth) {
+    if (SrcBitWidth == BitWidth)
+        return KBInstance;
+    Z3_ast BitOne = smtConstant(Ctx, 1, 1), BitZero = smtConstant(Ctx, 1, 0);
+    std::vector<Z3_ast> Zero(BitWidth), One(BitWidth);
+    // Copy the original known bits into the lower SrcBitWidth bits
+    for (unsigned i = 0; i < SrcBitWidth; ++i) {
+        Zero[i] = smtBit(Ctx, KBInstance.Zero, i);
+        One[i] = smtBit(Ctx, KBInstance.One, i);
+    }
+    // Extend a known-one sign bit, else a known-zero one
+    Z3_ast SignBitKnownOne = Z3_mk_eq(Ctx, smtBit(Ctx, KBInstance.One, SrcBitWidth - 1), BitOne);
+    Z3_ast SignBitKnownZero = Z3_mk_eq(Ctx, smtBit(Ctx, KBInstance.Zero, SrcBitWidth - 1), BitOne);
+    for (unsigned i = SrcBitWidth; i < BitWidth; ++i) {
+        One[i] = Z3_mk_ite(Ctx, SignBitKnownOne, BitOne, BitZero);
+        Zero[i] = Z3_mk_ite(Ctx, SignBitKnownOne, BitZero, Z3_mk_ite(Ctx, SignBitKnownZero, BitOne, BitZero));
+    }
+    return {smtFromBits(Ctx, Zero), smtFromBits(Ctx, One)};
+}
+
+// Symbolic zextInRegComposite
+SymbolicKnownBits smtZextInRegComposite(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                        unsigned BitWidth, unsigned SrcBitWidth) {
+    unsigned ExtBits = BitWidth - SrcBitWidth;
+    Z3_ast Zero = smtLshr(Ctx, smtShl(Ctx, KBInstance.Zero, BitWidth, ExtBits), BitWidth, ExtBits);
+    Z3_ast HighBits = Z3_mk_bvnot(Ctx, smtLowBits(Ctx, BitWidth, SrcBitWidth));
+    return {Z3_mk_bvor(Ctx, Zero, HighBits),
+            smtLshr(Ctx, smtShl(Ctx, KBInstance.One, BitWidth, ExtBits), BitWidth, ExtBits)};
+}
+
+// Symbolic zextInRegDecomposed
+SymbolicKnownBits smtZextInRegDecomposed(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                         unsigned BitWidth, unsigned SrcBitWidth) {
+    std::vector<Z3_ast> Zero(BitWidth), One(BitWidth);
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        bool Copied = i < SrcBitWidth;
+        Zero[i] = Copied ? smtBit(Ctx, KBInstance.Zero, i) : smtConstant(Ctx, 1, 1);
+        One[i] = Copied ? smtBit(Ctx, KBInstance.One, i) : smtConstant(Ctx, 1, 0);
+    }
+    return {smtFromBits(Ctx, Zero), smtFromBits(Ctx, One)};
+}
+
+// Symbolic shlComposite
+SymbolicKnownBits smtShlComposite(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                  unsigned BitWidth, unsigned ShiftAmt) {
+    return {Z3_mk_bvor(Ctx, smtShl(Ctx, KBInstance.Zero, BitWidth, ShiftAmt), smtLowBits(Ctx, BitWidth, ShiftAmt)),
+            smtShl(Ctx, KBInstance.One, BitWidth, ShiftAmt)};
+}
+
+// Symbolic shlDecomposed
+SymbolicKnownBits smtShlDecomposed(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                   unsigned BitWidth, unsigned ShiftAmt) {
+    std::vector<Z3_ast> Zero(BitWidth), One(BitWidth);
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        bool ShiftedIn = i < ShiftAmt;
+        Zero[i] = ShiftedIn ? smtConstant(Ctx, 1, 1) : smtBit(Ctx, KBInstance.Zero, i - ShiftAmt);
+        One[i] = ShiftedIn ? smtConstant(Ctx, 1, 0) : smtBit(Ctx, KBInstance.One, i - ShiftAmt);
+    }
+    return {smtFromBits(Ctx, Zero), smtFromBits(Ctx, One)};
+}
+
+// Symbolic lshrComposite
+SymbolicKnownBits smtLshrComposite(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                   unsigned BitWidth, unsigned ShiftAmt) {
+    Z3_ast HighBits = Z3_mk_bvnot(Ctx, smtLowBits(Ctx, BitWidth, BitWidth - ShiftAmt));
+    return {Z3_mk_bvor(Ctx, smtLshr(Ctx, KBInstance.Zero, BitWidth, ShiftAmt), HighBits),
+            smtLshr(Ctx, KBInstance.One, BitWidth, ShiftAmt)};
+}
+
+// Symbolic lshrDecomposed
+SymbolicKnownBits smtLshrDecomposed(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                    unsigned BitWidth, unsigned ShiftAmt) {
+    std::vector<Z3_ast> Zero(BitWidth), One(BitWidth);
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        bool ShiftedIn = i + ShiftAmt >= BitWidth;
+        Zero[i] = ShiftedIn ? smtConstant(Ctx, 1, 1) : smtBit(Ctx, KBInstance.Zero, i + ShiftAmt);
+        One[i] = ShiftedIn ? smtConstant(Ctx, 1, 0) : smtBit(Ctx, KBInstance.One, i + ShiftAmt);
+    }
+    return {smtFromBits(Ctx, Zero), smtFromBits(Ctx, One)};
+}
+
+// Symbolic ashrComposite
+SymbolicKnownBits smtAshrComposite(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                   unsigned BitWidth, unsigned ShiftAmt) {
+    return {smtAshr(Ctx, KBInstance.Zero, BitWidth, ShiftAmt), smtAshr(Ctx, KBInstance.One, BitWidth, ShiftAmt)};
+}
+
+// Symbolic ashrDecomposed
+SymbolicKnownBits smtAshrDecomposed(Z3_context Ctx, const SymbolicKnownBits &KBInstance,
+                                    unsigned BitWidth, unsigned ShiftAmt) {
+    std::vector<Z3_ast> Zero(BitWidth), One(BitWidth);
+    for (unsigned i = 0; i < BitWidth; ++i) {
+        unsigned SrcBit = std::min(i + ShiftAmt, BitWidth - 1);
+        Zero[i] = smtBit(Ctx, KBInstance.Zero, SrcBit);
+        One[i] = smtBit(Ctx, KBInstance.One, SrcBit);
+    }
+    return {smtFromBits(Ctx, Zero), smtFromBits(Ctx, One)};
+}
+
+// Registered transfer function pairs with a symbolic encoding
+static const SymbolicTransferFunction SymbolicTransferFunctions[] = {
+    {"sextInReg", smtSextInRegComposite, smtSextInRegDecomposed},
+    {"zextInReg", smtZextInRegComposite, smtZextInRegDecomposed},
+    {"shl", smtShlComposite, smtShlDecomposed},
+    {"lshr", smtLshrComposite, smtLshrDecomposed},
+    {"ashr", smtAshrComposite, smtAshrDecomposed},
+};
+
+// Function to look up the symbolic encoding of a registered operation, or null
+const SymbolicTransferFunction *findSymbolicTransferFunction(StringRef Name) {
+    for (const SymbolicTransferFunction &Fn : SymbolicTransferFunctions) {
+        if (Name == Fn.Name)
+            return &Fn;
+    }
+    return nullptr;
+}
+
+// Outcome of one solver query, with the input that satisfies it if there is one
+struct SymbolicAnswer {
+    Z3_lbool Status = Z3_L_UNDEF;
+    KnownBits Witness;
+};
+
+// Outcomes of the three queries of one configuration. The results are equally
+// precise for every input exactly when all three are unsatisfiable.
+struct SymbolicVerdict {
+    SymbolicAnswer CompositeMorePrecise;
+    SymbolicAnswer DecomposedMorePrecise;
+    SymbolicAnswer Incomparable;
+};
+
+// Function to solve Query on top of the assertions already in Solver
+SymbolicAnswer checkSymbolicQuery(Z3_context Ctx, Z3_solver Solver, Z3_ast Query,
+                                  const SymbolicKnownBits &Input, unsigned BitWidth) {
+    SymbolicAnswer Answer;
+    Z3_solver_push(Ctx, Solver);
+    Z3_solver_assert(Ctx, Solver, Query);
+    Answer.Status = Z3_solver_check(Ctx, Solver);
+    if (Answer.Status == Z3_L_TRUE) {
+        Z3_model Model = Z3_solver_get_model(Ctx, Solver);
+        Z3_model_inc_ref(Ctx, Model);
+        Z3_ast Zero, One;
+        Z3_model_eval(Ctx, Model, Input.Zero, true, &Zero);
+        Z3_model_eval(Ctx, Model, Input.One, true, &One);
+        Answer.Witness = KnownBits(BitWidth);
+        Answer.Witness.Zero = APInt(BitWidth, Z3_get_numeral_string(Ctx, Zero), 10);
+        Answer.Witness.One = APInt(BitWidth, Z3_get_numeral_string(Ctx, One), 10);
+        Z3_model_dec_ref(Ctx, Model);
+    }
+    Z3_solver_pop(Ctx, Solver, 1);
+    return Answer;
+}
+
+// Function to decide one configuration of a symbolically encoded pair. Each call
+// uses its own Z3 context, so configurations can be solved concurrently.
+SymbolicVerdict solveSymbolic(const SymbolicTransferFunction &Fn, unsigned BitWidth, unsigned Param) {
+    Z3_config Config = Z3_mk_config();
+    Z3_context Ctx = Z3_mk_context(Config);
+    Z3_del_config(Config);
+
+    Z3_sort Sort = Z3_mk_bv_sort(Ctx, BitWidth);
+    SymbolicKnownBits Input = {Z3_mk_const(Ctx, Z3_mk_string_symbol(Ctx, "Zero"), Sort),
+                               Z3_mk_const(Ctx, Z3_mk_string_symbol(Ctx, "One"), Sort)};
+    SymbolicKnownBits Composite = Fn.Composite(Ctx, Input, BitWidth, Param);
+    SymbolicKnownBits Decomposed = Fn.Decomposed(Ctx, Input, BitWidth, Param);
+
+    // A result is at least as precise as another when it knows every bit the
+    // other knows, as in comparePrecision
+    Z3_ast CompositeRefines[] = {smtIsSubsetOf(Ctx, Decomposed.Zero, Composite.Zero, BitWidth),
+                                 smtIsSubsetOf(Ctx, Decomposed.One, Composite.One, BitWidth)};
+    Z3_ast DecomposedRefines[] = {smtIsSubsetOf(Ctx, Composite.Zero, Decomposed.Zero, BitWidth),
+                                  smtIsSubsetOf(Ctx, Composite.One, Decomposed.One, BitWidth)};
+    Z3_ast CompositeAtLeast = Z3_mk_and(Ctx, 2, CompositeRefines);
+    Z3_ast DecomposedAtLeast = Z3_mk_and(Ctx, 2, DecomposedRefines);
+
+    Z3_solver Solver = Z3_mk_solver(Ctx);
+    Z3_solver_inc_ref(Ctx, Solver);
+    Z3_solver_assert(Ctx, Solver, smtIsSubsetOf(Ctx, Input.Zero, Z3_mk_bvnot(Ctx, Input.One), BitWidth));
+
+    Z3_ast CompositeQuery[] = {CompositeAtLeast, Z3_mk_not(Ctx, DecomposedAtLeast)};
+    Z3_ast DecomposedQuery[] = {DecomposedAtLeast, Z3_mk_not(Ctx, CompositeAtLeast)};
+    Z3_ast IncomparableQuery[] = {Z3_mk_not(Ctx, CompositeAtLeast), Z3_mk_not(Ctx, DecomposedAtLeast)};
+    SymbolicVerdict Verdict;
+    Verdict.CompositeMorePrecise =
+        checkSymbolicQuery(Ctx, Solver, Z3_mk_and(Ctx, 2, CompositeQuery), Input, BitWidth);
+    Verdict.DecomposedMorePrecise =
+        checkSymbolicQuery(Ctx, Solver, Z3_mk_and(Ctx, 2, DecomposedQuery), Input, BitWidth);
+    Verdict.Incomparable = checkSymbolicQuery(Ctx, Solver, Z3_mk_and(Ctx, 2, IncomparableQuery), Input, BitWidth);
+
+    Z3_solver_dec_ref(Ctx, Solver);
+    Z3_del_context(Ctx);
+    return Verdict;
+}
+
+// Function to print one query outcome. A witness is replayed through the APInt
+// functions of Op, and a replay that disagrees with the query points at an
+// encoding that no longer matches the C++ function.
+void printSymbolicAnswer(const char *Label, const SymbolicAnswer &Answer, PrecisionOrder Expected,
+                         const TransferFunctionInfo &Op, unsigned Param) {
+    std::cout << Label << ": ";
+    if (Answer.Status == Z3_L_FALSE) {
+        std::cout << "never\n";
+        return;
+    }
+    if (Answer.Status == Z3_L_UNDEF) {
+        std::cout << "unknown\n";
+        return;
+    }
+    KnownBits CompositeResult = Op.Composite(Answer.Witness, Param);
+    KnownBits DecomposedResult = Op.Decomposed(Answer.Witness, Param);
+    std::cout << "possible, input " << formatKnownBits(Answer.Witness)
+              << ", composite " << formatKnownBits(CompositeResult)
+              << ", decomposed " << formatKnownBits(DecomposedResult) << "\n";
+    if (comparePrecision(CompositeResult, DecomposedResult) != Expected)
+        std::cout << "warning: the witness does not reproduce with the APInt functions\n";
+}
+
+// Function to decide every selected configuration with the symbolic backend.
+// Configurations are solved in parallel, and each distinct (operation, BitWidth,
+// Param) is solved once however often it is requested, then reported in order.
+void runSymbolicTests(ThreadPool &Pool, const std::vector<const TransferFunctionInfo *> &Operations) {
+    typedef std::pair<const TransferFunctionInfo *, std::pair<unsigned, unsigned>> ConfigKey;
+    std::vector<ConfigKey> Configs;
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        for (const TransferFunctionInfo *Op : Operations) {
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth))
+                Configs.push_back({Op, {BitWidth, Param}});
+        }
+    }
+
+    std::map<ConfigKey, SymbolicVerdict> Cache;
+    for (const ConfigKey &Key : Configs) {
+        if (Cache.count(Key))
+            continue;
+        SymbolicVerdict &Verdict = Cache[Key];
+        const SymbolicTransferFunction *Fn = findSymbolicTransferFunction(Key.first->Name);
+        Pool.async([&Verdict, Fn, Key] { Verdict = solveSymbolic(*Fn, Key.second.first, Key.second.second); });
+    }
+    Pool.wait();
+
+    for (const ConfigKey &Key : Configs) {
+        const TransferFunctionInfo &Op = *Key.first;
+        unsigned BitWidth = Key.second.first, Param = Key.second.second;
+        const SymbolicVerdict &Verdict = Cache[Key];
+        bool Decided = Verdict.CompositeMorePrecise.Status != Z3_L_UNDEF &&
+                       Verdict.DecomposedMorePrecise.Status != Z3_L_UNDEF &&
+                       Verdict.Incomparable.Status != Z3_L_UNDEF;
+        bool AlwaysEqual = Verdict.CompositeMorePrecise.Status == Z3_L_FALSE &&
+                           Verdict.DecomposedMorePrecise.Status == Z3_L_FALSE &&
+                           Verdict.Incomparable.Status == Z3_L_FALSE;
+
+        std::cout << "Operation: " << Op.Name << "\n";
+        std::cout << "BitWidth: " << BitWidth;
+        if (Op.Param != ParamKind::None)
+            std::cout << ", " << getParamName(Op.Param) << ": " << Param;
+        std::cout << "\n";
+        std::cout << "Equal Precision: " << (AlwaysEqual ? "always" : Decided ? "not always" : "unknown") << "\n";
+        printSymbolicAnswer("Composite More Precise", Verdict.CompositeMorePrecise,
+                            PrecisionOrder::FirstMorePrecise, Op, Param);
+        printSymbolicAnswer("Decomposed More Precise", Verdict.DecomposedMorePrecise,
+                            PrecisionOrder::SecondMorePrecise, Op, Param);
+        printSymbolicAnswer("Incomparable Results", Verdict.Incomparable, PrecisionOrder::Incomparable, Op, Param);
+        std::cout << "\n";
+    }
+}
+#endif // VERIFY_WITH_Z3
+
+// Function to resolve the --op names into registered transfer function pairs.
+// Returns false if a name is not registered.
+bool selectTransferFunctions(std::vector<const TransferFunctionInfo *> &Selected) {
+    for (const std::string &Name : Options.OperationNames) {
+        if (Name == "all") {
+            for (const TransferFunctionInfo &Info : TransferFunctions)
+                Selected.push_back(&Info);
+            continue;
+        }
+        const TransferFunctionInfo *Info = findTransferFunction(Name);
+        if (!Info) {
+            errs() << "error: unknown operation '" << Name << "', see --list-ops\n";
+            return false;
+        }
+        Selected.push_back(Info);
+    }
+    return true;
+}
+
+// Function to print the registered transfer function pairs
+void listTransferFunctions(raw_ostream &OS) {
+    for (const TransferFunctionInfo &Info : TransferFunctions) {
+        OS << "  " << Info.Name << ": " << Info.Description << " (arity " << Info.Arity;
+        if (Info.Param != ParamKind::None)
+            OS << ", parameter " << getParamName(Info.Param);
+        OS << ")\n";
+    }
+}
+
+// Number of samples drawn from one generator, and handed to a worker at a time
+static const uint64_t SampleChunkSize = 4096;
+
+// Function to compute the Wilson score interval at 95% confidence of a
+// proportion observed Hits times in Samples trials. Unlike the normal
+// approximation it stays informative when no hit is observed.
+std::pair<double, double> wilsonInterval(uint64_t Hits, uint64_t Samples) {
+    if (Samples == 0)
+        return {0, 1};
+    const double Z = 1.959963984540054;
+    double N = Samples, P = Hits / N;
+    double Denominator = 1 + Z * Z / N;
+    double Center = (P + Z * Z / (2 * N)) / Denominator;
+    double HalfWidth = Z * std::sqrt(P * (1 - P) / N + Z * Z / (4 * N * N)) / Denominator;
+    // The bounds at no hits and all hits are exact, without rounding noise
+    return {Hits == 0 ? 0 : std::max(0.0, Center - HalfWidth),
+            Hits == Samples ? 1 : std::min(1.0, Center + HalfWidth)};
+}
+
+// Function to get the fraction of the inputs over InputBits bits that have
+// exactly NumUnknown unknown bits, C(InputBits, NumUnknown) 2^(InputBits -
+// NumUnknown) / 3^InputBits, computed in the log domain
+double unknownBitsStratumWeight(unsigned InputBits, unsigned NumUnknown) {
+    double LogWeight = std::lgamma(InputBits + 1.0) - std::lgamma(NumUnknown + 1.0) -
+                       std::lgamma(InputBits - NumUnknown + 1.0) + (InputBits - NumUnknown) * std::log(2.0) -
+                       InputBits * std::log(3.0);
+    return std::exp(LogWeight);
+}
+
+// Function to print one precision class of a sampled configuration: the number
+// of samples that fell in it, the estimated fraction of the whole domain, and a
+// 95% confidence interval for that fraction
+void printSampledClass(const char *Label, uint64_t Hits, double Estimate, std::pair<double, double> Interval) {
+    std::cout << Label << ": " << Hits << " (" << 100 * Estimate << "%, 95% CI " << 100 * Interval.first << "% to "
+              << 100 * Interval.second << "%)\n";
+}
+
+// Function to compare the composite and decomposed functions of Op on a sample of
+// exactly Options.SampleBudget inputs. Uniform samples estimate each precision
+// class by its observed frequency. Stratified samples split the budget evenly
+// over every number of unknown bits, the first strata taking one sample more
+// when it does not divide, so values with few or many unknown bits,
+// which uniform sampling rarely draws, are covered too; each stratum's frequency
+// is weighted by its share of the domain, and the bounds are the weighted sums
+// of the per-stratum Wilson bounds, which is conservative.
+void testSampled(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param) {
+    bool Binary = Op.Arity == 2;
+    unsigned InputBits = Op.Arity * BitWidth;
+    unsigned NumStrata = Options.Stratified ? InputBits + 1 : 1;
+    assert(Options.SampleBudget >= NumStrata && "Fewer samples than strata");
+    uint64_t NumSamples = Options.SampleBudget;
+    uint64_t PerStratum = NumSamples / NumStrata, Remainder = NumSamples % NumStrata;
+    // Samples of the first Remainder strata, which take PerStratum + 1 each
+    uint64_t LargeStrataSamples = Remainder * (PerStratum + 1);
+    auto getStratumSamples = [&](unsigned Stratum) { return PerStratum + (Stratum < Remainder); };
+
+    // Counters per worker and stratum
+    std::vector<std::vector<PrecisionCounts>> WorkerCounts(Pool.getThreadCount(),
+                                                           std::vector<PrecisionCounts>(NumStrata));
+    parallelForChunks(Pool, NumSamples, SampleChunkSize, [&](unsigned Worker, uint64_t Begin, uint64_t End) {
+        RandomBits Random(Options.Seed ^ (uint64_t(BitWidth) << 48) ^ (uint64_t(Param) << 40) ^
+                          (Begin / SampleChunkSize));
+        KnownBits Operands[2] = {KnownBits(BitWidth), KnownBits(BitWidth)};
+        KnownBits CompositeResult(BitWidth), DecomposedResult(BitWidth);
+        std::vector<unsigned> Positions;
+        for (uint64_t Sample = Begin; Sample < End; ++Sample) {
+            unsigned Stratum = Sample < LargeStrataSamples
+                                   ? Sample / (PerStratum + 1)
+                                   : Remainder + (Sample - LargeStrataSamples) / PerStratum;
+            if (Options.Stratified)
+                sampleWithUnknownBits(Random, Stratum, Positions, Operands, Op.Arity);
+            else
+                sampleUniform(Random, Operands, Op.Arity);
+            if (Binary) {
+                CompositeResult = Op.CompositeBinary(Operands[0], Operands[1]);
+                DecomposedResult = Op.DecomposedBinary(Operands[0], Operands[1]);
+            } else {
+                Op.CompositeInto(Operands[0], Param, CompositeResult);
+                Op.DecomposedInto(Operands[0], Param, DecomposedResult);
+            }
+            PrecisionCounts &Counts = WorkerCounts[Worker][Stratum];
+            PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+            if (Options.CrossCheck && Order != comparePrecisionByConcretization(CompositeResult, DecomposedResult))
+                Counts.CrossCheckMismatches++;
+            Counts.record(Order);
+        }
+    });
+
+    std::vector<PrecisionCounts> StratumCounts(NumStrata);
+    PrecisionCounts Counts;
+    for (const std::vector<PrecisionCounts> &Partials : WorkerCounts) {
+        for (unsigned Stratum = 0; Stratum < NumStrata; ++Stratum) {
+            StratumCounts[Stratum] += Partials[Stratum];
+            Counts += Partials[Stratum];
+        }
+    }
+
+    std::cout << "Operation: " << Op.Name << "\n";
+    std::cout << "BitWidth: " << BitWidth;
+    if (Op.Param != ParamKind::None)
+        std::cout << ", " << getParamName(Op.Param) << ": " << Param;
+    std::cout << "\n";
+    std::string Spread = std::to_string(PerStratum) + (Remainder != 0 ? " or " + std::to_string(PerStratum + 1) : "");
+    std::cout << "Sampled Values: " << Counts.TotalComparisons << " (" << (Options.Stratified ? "stratified by "
+              "unknown bits, " + Spread + " per count" : std::string("uniform")) << ")\n";
+    struct {
+        const char *Label;
+        uint64_t PrecisionCounts::*Counter;
+    } Classes[] = {{"Equal Precision", &PrecisionCounts::EquallyPrecise},
+                   {"Composite More Precise", &PrecisionCounts::CompositeMorePrecise},
+                   {"Decomposed More Precise", &PrecisionCounts::DecomposedMorePrecise},
+                   {"Incomparable Results", &PrecisionCounts::Incomparable}};
+    for (const auto &Class : Classes) {
+        if (!Options.Stratified) {
+            uint64_t Hits = Counts.*Class.Counter;
+            printSampledClass(Class.Label, Hits, double(Hits) / NumSamples, wilsonInterval(Hits, NumSamples));
+            continue;
+        }
+        double Estimate = 0, Lower = 0, Upper = 0;
+        for (unsigned Stratum = 0; Stratum < NumStrata; ++Stratum) {
+            uint64_t Hits = StratumCounts[Stratum].*Class.Counter;
+            double Weight = unknownBitsStratumWeight(InputBits, Stratum);
+            uint64_t StratumSamples = getStratumSamples(Stratum);
+            std::pair<double, double> Interval = wilsonInterval(Hits, StratumSamples);
+            Estimate += Weight * Hits / StratumSamples;
+            Lower += Weight * Interval.first;
+            Upper += Weight * Interval.second;
+        }
+        printSampledClass(Class.Label, Counts.*Class.Counter, Estimate, {Lower, std::min(1.0, Upper)});
+    }
+    if (Options.CrossCheck)
+        std::cout << "Cross-check Mismatches: " << Counts.CrossCheckMismatches << "\n";
+    std::cout << "\n";
+}
+
+// Number of unknown-bit masks handed to a --find-first worker at a time
+static const uint64_t FindFirstChunkSize = 1024;
+
+// Input on which the composite function loses precision, found by --find-first
+struct Counterexample {
+    PrecisionOrder Order;
+    KnownBits LHS, RHS; // RHS is only set for binary operations
+    KnownBits CompositeResult, DecomposedResult;
+};
+
+// Function to find a concrete value admitted by A but not by B. Such a value
+// exists when B knows a bit that A does not know or knows with the other value;
+// A must be conflict free. Returns false if there is none.
+bool findDistinguishingValue(const KnownBits &A, const KnownBits &B, APInt &Value) {
+    for (unsigned Bit = 0; Bit < A.getBitWidth(); ++Bit) {
+        bool BZero = B.Zero[Bit], BOne = B.One[Bit];
+        if (!BZero && !BOne)
+            continue;
+        if (BZero ? A.Zero[Bit] : A.One[Bit])
+            continue;
+        Value = A.One;
+        if (BZero)
+            Value.setBit(Bit);
+        else
+            Value.clearBit(Bit);
+        return true;
+    }
+    return false;
+}
+
+// Function to search a configuration for an input whose decomposed result is
+// more precise than the composite one, or incomparable with it. Inputs are
+// searched by increasing number of unknown bits, so the witness has as few as
+// possible; within a level the unknown masks are claimed in increasing order,
+// and workers drop masks above the best hit so far, which makes the witness the
+// one with the smallest mask whatever the thread timing. Binary inputs are the
+// two operands' masks side by side, LHS in the high bits.
+bool findCounterexample(ThreadPool &Pool, const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                        Counterexample &Found) {
+    bool Binary = Op.Arity == 2;
+    unsigned InputBits = Op.Arity * BitWidth;
+    assert(InputBits <= MaxExhaustiveBitWidth && "Input masks too wide");
+    uint64_t InputMask = maskTrailingOnes<uint64_t>(InputBits);
+    uint64_t OperandMask = maskTrailingOnes<uint64_t>(BitWidth);
+
+    std::atomic<uint64_t> BestMask(UINT64_MAX);
+    std::mutex Lock;
+    for (unsigned NumUnknown = 0; NumUnknown <= InputBits && BestMask == UINT64_MAX; ++NumUnknown) {
+        parallelForChunks(Pool, InputMask + 1, FindFirstChunkSize, [&](unsigned, uint64_t Begin, uint64_t End) {
+            KnownBits LHS(BitWidth), RHS(BitWidth), CompositeResult(BitWidth), DecomposedResult(BitWidth);
+            for (uint64_t Unknown = Begin; Unknown < End && Unknown < BestMask; ++Unknown) {
+                if (countPopulation(Unknown) != NumUnknown)
+                    continue;
+                // Walk every assignment of the known bits
+                uint64_t Known = ~Unknown & InputMask;
+                uint64_t Ones = 0;
+                do {
+                    uint64_t Zeros = Known & ~Ones;
+                    LHS.Zero = APInt(BitWidth, Binary ? Zeros >> BitWidth : Zeros);
+                    LHS.One = APInt(BitWidth, Binary ? Ones >> BitWidth : Ones);
+                    if (Binary) {
+                        RHS.Zero = APInt(BitWidth, Zeros & OperandMask);
+                        RHS.One = APInt(BitWidth, Ones & OperandMask);
+                        CompositeResult = Op.CompositeBinary(LHS, RHS);
+                        DecomposedResult = Op.DecomposedBinary(LHS, RHS);
+                    } else {
+                        Op.CompositeInto(LHS, Param, CompositeResult);
+                        Op.DecomposedInto(LHS, Param, DecomposedResult);
+                    }
+                    PrecisionOrder Order = comparePrecision(CompositeResult, DecomposedResult);
+                    if (Order == PrecisionOrder::SecondMorePrecise || Order == PrecisionOrder::Incomparable) {
+                        // Masks are handled by one worker each, so the first hit
+                        // of a mask is its only candidate
+                        std::lock_guard<std::mutex> Guard(Lock);
+                        if (Unknown < BestMask) {
+                            BestMask = Unknown;
+                            Found = {Order, LHS, RHS, CompositeResult, DecomposedResult};
+                        }
+                        break;
+                    }
+                    Ones = (Ones - Known) & Known;
+                } while (Ones != 0);
+            }
+        });
+    }
+    return BestMask != UINT64_MAX;
+}
+
+// Function to print a counterexample with the concrete values that tell the
+// two results apart
+void printCounterexample(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                         const Counterexample &Found) {
+    std::cout << "Operation: " << Op.Name << "\n";
+    std::cout << "BitWidth: " << BitWidth;
+    if (Op.Param != ParamKind::None)
+        std::cout << ", " << getParamName(Op.Param) << ": " << Param;
+    std::cout << "\n";
+    std::cout << "Counterexample: "
+              << (Found.Order == PrecisionOrder::Incomparable ? "Incomparable Results" : "Decomposed More Precise")
+              << "\n";
+    if (Op.Arity == 2) {
+        std::cout << "LHS: " << formatKnownBits(Found.LHS) << "\n";
+        std::cout << "RHS: " << formatKnownBits(Found.RHS) << "\n";
+    } else {
+        std::cout << "Input: " << formatKnownBits(Found.LHS) << "\n";
+    }
+    std::cout << "Composite Result: " << formatKnownBits(Found.CompositeResult) << "\n";
+    std::cout << "Decomposed Result: " << formatKnownBits(Found.DecomposedResult) << "\n";
+    APInt Value;
+    KnownBits ValueBits(BitWidth);
+    if (findDistinguishingValue(Found.CompositeResult, Found.DecomposedResult, Value)) {
+        ValueBits.One = Value;
+        ValueBits.Zero = ~Value;
+        std::cout << "Composite Only Value: " << formatKnownBits(ValueBits) << "\n";
+    }
+    if (findDistinguishingValue(Found.DecomposedResult, Found.CompositeResult, Value)) {
+        ValueBits.One = Value;
+        ValueBits.Zero = ~Value;
+        std::cout << "Decomposed Only Value: " << formatKnownBits(ValueBits) << "\n";
+    }
+}
+
+// Function to search every selected configuration for a counterexample, in the
+// order runTests sweeps them, stopping at the first one found. Returns false if
+// one was found.
+bool runFindFirst(ThreadPool &Pool, const std::vector<const TransferFunctionInfo *> &Operations) {
+    unsigned NumConfigs = 0;
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        for (const TransferFunctionInfo *Op : Operations) {
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth)) {
+                Counterexample Found;
+                ++NumConfigs;
+                if (findCounterexample(Pool, *Op, BitWidth, Param, Found)) {
+                    printCounterexample(*Op, BitWidth, Param, Found);
+                    return false;
+                }
+            }
+        }
+    }
+    std::cout << "No counterexample in " << NumConfigs << " configurations\n";
+    return true;
+}
+
+// Largest bitwidth whose std::set stages --bench times. Above it they take
+// minutes per run, and the sweeps no longer use them.
+static const unsigned MaxBenchSetBitWidth = 10;
+
+// Number of result pairs the set-based stages concretize before comparing, so
+// that concretization and std::includes are timed apart without a clock read
+// per value
+static const unsigned BenchBlockSize = 256;
+
+// Stages of a configuration timed by --bench, in report order
+enum BenchStage {
+    BenchEnumerate,
+    BenchComposite,
+    BenchDecomposed,
+    BenchCompare,
+    BenchConcretizeBitset,
+    BenchIncludesBitset,
+    BenchConcretizeSet,
+    BenchIncludesSet,
+    NumBenchStages
+};
+
+static const char *const BenchStageNames[NumBenchStages] = {
+    "enumerateKnownBits", "composite", "decomposed", "compare", "concretize (bitset)", "includes (bitset)",
+    "concretize (std::set)", "includes (std::set)"};
+
+// Keeps the results of the timed stages observable, so none is optimized away
+static volatile uint64_t BenchSink;
+
+// Function to time every stage of verifying a unary configuration once, single
+// threaded, adding each stage's seconds to StageSeconds. The std::set stages
+// run up to MaxBenchSetBitWidth.
+void benchTransferFunctionsOnce(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param,
+                                double StageSeconds[NumBenchStages]) {
+    typedef std::chrono::steady_clock Clock;
+    std::vector<KnownBits> Inputs;
+    Clock::time_point Start = Clock::now();
+    enumerateKnownBits(BitWidth, Inputs);
+    StageSeconds[BenchEnumerate] += getSecondsSince(Start);
+
+    std::vector<KnownBits> CompositeResults(Inputs.size(), KnownBits(BitWidth));
+    std::vector<KnownBits> DecomposedResults(Inputs.size(), KnownBits(BitWidth));
+    Start = Clock::now();
+    for (size_t i = 0; i < Inputs.size(); ++i)
+        Op.CompositeInto(Inputs[i], Param, CompositeResults[i]);
+    StageSeconds[BenchComposite] += getSecondsSince(Start);
+    Start = Clock::now();
+    for (size_t i = 0; i < Inputs.size(); ++i)
+        Op.DecomposedInto(Inputs[i], Param, DecomposedResults[i]);
+    StageSeconds[BenchDecomposed] += getSecondsSince(Start);
+
+    uint64_t Sink = 0;
+    Start = Clock::now();
+    for (size_t i = 0; i < Inputs.size(); ++i)
+        Sink += unsigned(comparePrecision(CompositeResults[i], DecomposedResults[i]));
+    StageSeconds[BenchCompare] += getSecondsSince(Start);
+
+    bool TimeSets = BitWidth <= MaxBenchSetBitWidth;
+    std::vector<ConcreteValueSet> CompositeBitsets(BenchBlockSize), DecomposedBitsets(BenchBlockSize);
+    std::vector<std::set<APInt, APIntComparator>> CompositeSets(BenchBlockSize), DecomposedSets(BenchBlockSize);
+    for (size_t BlockBegin = 0; BlockBegin < Inputs.size(); BlockBegin += BenchBlockSize) {
+        size_t BlockSize = std::min<size_t>(BenchBlockSize, Inputs.size() - BlockBegin);
+        Start = Clock::now();
+        for (size_t i = 0; i < BlockSize; ++i) {
+            CompositeBitsets[i].assign(CompositeResults[BlockBegin + i]);
+            DecomposedBitsets[i].assign(DecomposedResults[BlockBegin + i]);
+        }
+        StageSeconds[BenchConcretizeBitset] += getSecondsSince(Start);
+        Start = Clock::now();
+        for (size_t i = 0; i < BlockSize; ++i)
+            Sink += CompositeBitsets[i].includes(DecomposedBitsets[i]) +
+                    DecomposedBitsets[i].includes(CompositeBitsets[i]);
+        StageSeconds[BenchIncludesBitset] += getSecondsSince(Start);
+        if (!TimeSets)
+            continue;
+
+        Start = Clock::now();
+        for (size_t i = 0; i < BlockSize; ++i) {
+            CompositeSets[i].clear();
+            DecomposedSets[i].clear();
+            concretize(CompositeResults[BlockBegin + i], CompositeSets[i]);
+            concretize(DecomposedResults[BlockBegin + i], DecomposedSets[i]);
+        }
+        StageSeconds[BenchConcretizeSet] += getSecondsSince(Start);
+        Start = Clock::now();
+        for (size_t i = 0; i < BlockSize; ++i) {
+            Sink += std::includes(DecomposedSets[i].begin(), DecomposedSets[i].end(), CompositeSets[i].begin(),
+                                  CompositeSets[i].end(), APIntComparator());
+            Sink += std::includes(CompositeSets[i].begin(), CompositeSets[i].end(), DecomposedSets[i].begin(),
+                                  DecomposedSets[i].end(), APIntComparator());
+        }
+        StageSeconds[BenchIncludesSet] += getSecondsSince(Start);
+    }
+    BenchSink = BenchSink + Sink;
+}
+
+// Function to benchmark a unary configuration: one untimed warm-up, then
+// Options.Repetitions timed runs. Each stage is reported as the mean throughput
+// in abstract values per second, with its standard deviation over the runs and
+// the mean time per run.
+void benchTransferFunctions(const TransferFunctionInfo &Op, unsigned BitWidth, unsigned Param) {
+    double WarmUp[NumBenchStages] = {};
+    benchTransferFunctionsOnce(Op, BitWidth, Param, WarmUp);
+    std::vector<std::array<double, NumBenchStages>> Runs(Options.Repetitions);
+    for (std::array<double, NumBenchStages> &Run : Runs) {
+        Run.fill(0);
+        benchTransferFunctionsOnce(Op, BitWidth, Param, Run.data());
+    }
+
+    double NumValues = numAbstractValues(BitWidth);
+    unsigned NumStages = BitWidth <= MaxBenchSetBitWidth ? NumBenchStages : BenchConcretizeSet;
+    if (Options.Format == OutputFormat::Text) {
+        std::cout << "Benchmark: " << Op.Name << "\n";
+        std::cout << "BitWidth: " << BitWidth;
+        if (Op.Param != ParamKind::None)
+            std::cout << ", " << getParamName(Op.Param) << ": " << Param;
+        std::cout << "\n";
+        std::cout << "Abstract Values: " << uint64_t(NumValues) << ", Repetitions: " << Options.Repetitions << "\n";
+    }
+    for (unsigned Stage = 0; Stage < NumStages; ++Stage) {
+        double MeanSeconds = 0, MeanRate = 0, Variance = 0;
+        for (const std::array<double, NumBenchStages> &Run : Runs) {
+            MeanSeconds += Run[Stage] / Runs.size();
+            MeanRate += NumValues / Run[Stage] / Runs.size();
+        }
+        for (const std::array<double, NumBenchStages> &Run : Runs)
+            Variance += (NumValues / Run[Stage] - MeanRate) * (NumValues / Run[Stage] - MeanRate);
+        double StdDev = Runs.size() > 1 ? std::sqrt(Variance / (Runs.size() - 1)) : 0;
+        if (Options.Format == OutputFormat::JSON) {
+            std::cout << "{\"op\":\"" << Op.Name << "\",\"bitwidth\":" << BitWidth << ",\"param\":" << Param
+                      << ",\"stage\":\"" << BenchStageNames[Stage] << "\",\"values_per_second\":" << MeanRate
+                      << ",\"values_per_second_stddev\":" << StdDev << ",\"seconds\":" << MeanSeconds
+                      << ",\"repetitions\":" << Options.Repetitions << "}\n";
+        } else if (Options.Format == OutputFormat::CSV) {
+            std::cout << Op.Name << "," << BitWidth << "," << Param << "," << BenchStageNames[Stage] << ","
+                      << MeanRate << "," << StdDev << "," << MeanSeconds << "," << Options.Repetitions << "\n";
+        } else {
+            std::cout << BenchStageNames[Stage] << ": " << MeanRate << " values/s (stddev " << StdDev << "), "
+                      << MeanSeconds << " s per run\n";
+        }
+    }
+    if (Options.Format == OutputFormat::Text)
+        std::cout << "\n";
+}
+
+// Function to benchmark every configuration of the unary operations
+bool runBench(const std::vector<const TransferFunctionInfo *> &Operations) {
+    if (Options.Format == OutputFormat::CSV)
+        std::cout << "op,bitwidth,param,stage,values_per_second,values_per_second_stddev,seconds,repetitions\n";
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        for (const TransferFunctionInfo *Op : Operations) {
+            if (Op->Arity != 1)
+                continue;
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth))
+                benchTransferFunctions(*Op, BitWidth, Param);
+        }
+    }
+    return true;
+}
+
+// Function to combine the files written by the shards of a run with these
+// options. Every shard must appear once; the summed counts of each
+// configuration are printed as the unsharded run prints them.
+bool mergeShards(const std::vector<const TransferFunctionInfo *> &Operations) {
+    std::map<std::string, PrecisionCounts> Totals;
+    std::map<std::string, unsigned> NumShardsSeen;
+    std::vector<bool> ShardSeen;
+    for (const std::string &Path : Options.MergePaths) {
+        std::ifstream In(Path);
+        std::string Line, Tag, Version, Signature;
+        unsigned Index = 0, Count = 0;
+        if (!In || !std::getline(In, Line)) {
+            errs() << "error: cannot read " << Path << "\n";
+            return false;
+        }
+        std::istringstream Header(Line);
+        Header >> Tag >> Version >> Index >> Count;
+        std::getline(Header >> std::ws, Signature);
+        if (Tag == "shard" && Version != ShardVersion) {
+            errs() << "error: " << Path << " is a shard of another format, this build reads " << ShardVersion
+                   << "\n";
+            return false;
+        }
+        if (Tag != "shard" || Signature != getRunSignature()) {
+            errs() << "error: " << Path << " is not a shard of this run\n";
+            return false;
+        }
+        if (ShardSeen.empty())
+            ShardSeen.resize(Count);
+        if (Count != ShardSeen.size() || Index >= Count || ShardSeen[Index]) {
+            errs() << "error: " << Path << " repeats shard " << Index << " or has another shard count\n";
+            return false;
+        }
+        ShardSeen[Index] = true;
+        while (std::getline(In, Line)) {
+            std::istringstream Fields(Line);
+            std::string Name;
+            unsigned BitWidth, Param;
+            PrecisionCounts Counts;
+            Fields >> Tag >> Name >> BitWidth >> Param;
+            if (Tag != "counts" || !readCounters(Fields, Counts)) {
+                errs() << "error: malformed shard line '" << Line << "' in " << Path << "\n";
+                return false;
+            }
+            std::string Config = getConfigKey(Name, BitWidth, Param);
+            Totals[Config] += Counts;
+            ++NumShardsSeen[Config];
+        }
+    }
+    for (unsigned Index = 0; Index < ShardSeen.size(); ++Index) {
+        if (!ShardSeen[Index]) {
+            errs() << "error: shard " << Index << " of " << ShardSeen.size() << " is missing\n";
+            return false;
+        }
+    }
+
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        for (const TransferFunctionInfo *Op : Operations) {
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth)) {
+                std::string Config = getConfigKey(Op->Name, BitWidth, Param);
+                if (NumShardsSeen[Config] != ShardSeen.size()) {
+                    errs() << "error: configuration '" << Config << "' is not reported by every shard\n";
+                    return false;
+                }
+                printPrecisionCounts(*Op, BitWidth, Param, Totals[Config], Totals[Config].TotalComparisons, -1);
+            }
+        }
+    }
+    return true;
+}
+
+#ifdef VERIFY_STATS
+// Every allocation is counted, to show how often the sweeps reach the heap.
+// APInts wider than 64 bits allocate their words here.
+void *operator new(size_t Size) {
+    VERIFY_STAT(HeapAllocations, 1);
+    VERIFY_STAT(HeapBytes, Size);
+    if (void *Ptr = std::malloc(Size ? Size : 1))
+        return Ptr;
+    report_bad_alloc_error("operator new failed");
+}
+// Out of line, so compilers do not flag the free of a pointer from operator new
+LLVM_ATTRIBUTE_NOINLINE static void releaseAllocation(void *Ptr) { std::free(Ptr); }
+void operator delete(void *Ptr) noexcept { releaseAllocation(Ptr); }
+void operator delete(void *Ptr, size_t) noexcept { releaseAllocation(Ptr); }
+
+// Function to print the instrumentation counters of the run
+void printStats(raw_ostream &OS) {
+    OS << "Stats:\n";
+    OS << "  concretize Calls: " << Stats.ConcretizeCalls << ", Set Insertions: " << Stats.SetInsertions << "\n";
+    OS << "  Bitset Concretizations: " << Stats.BitsetConcretizations
+       << ", Bitset Insertions: " << Stats.BitsetInsertions << "\n";
+    OS << "  Heap Allocations: " << Stats.HeapAllocations << ", Heap Bytes: " << Stats.HeapBytes << "\n";
+    OS << "  enumerateKnownBits Peak Bytes: " << Stats.EnumeratedBytes << "\n";
+    OS << "  Parallel Regions: " << Stats.ParallelRegions << "\n";
+    for (unsigned Worker = 0; Worker < MaxStatsWorkers; ++Worker) {
+        uint64_t Busy = Stats.WorkerBusyNanos[Worker], Idle = Stats.WorkerIdleNanos[Worker];
+        if (Busy == 0 && Idle == 0)
+            continue;
+        OS << "  Worker " << Worker << (Worker == MaxStatsWorkers - 1 ? "+" : "") << ": busy "
+           << format("%.3f", Busy / 1e9) << " s, idle " << format("%.3f", Idle / 1e9) << " s\n";
+    }
+}
+#endif
+
+// Function to run tests for the selected operations and range of bit widths
+// (sextInReg at bit widths 4 to 8 by default)
+bool runTests(const std::vector<const TransferFunctionInfo *> &Operations) {
+    ThreadPool Pool(hardware_concurrency(Options.NumThreads));
+    if (Options.Bench)
+        return runBench(Operations);
+    if (Options.Format == OutputFormat::CSV)
+        printCSVHeader();
+    if (!Options.MergePaths.empty())
+        return mergeShards(Operations);
+    if (!Options.DiffPath.empty() && !BaselineStore.open(Options.DiffPath))
+        return false;
+    if (!Options.CachePath.empty() && !Cache.load(Options.CachePath))
+        return false;
+    if (!Options.StorePath.empty()) {
+        std::vector<StoreEntry> Entries;
+        for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+            for (const TransferFunctionInfo *Op : Operations) {
+                if (Op->Arity != 1)
+                    continue;
+                for (unsigned Param : getSweptParams(Op->Param, BitWidth)) {
+                    StoreEntry Entry = {};
+                    std::strncpy(Entry.Name, Op->Name, sizeof(Entry.Name) - 1);
+                    Entry.BitWidth = BitWidth;
+                    Entry.Param = Param;
+                    Entry.NumValues = numAbstractValues(BitWidth);
+                    Entries.push_back(Entry);
+                }
+            }
+        }
+        if (!ResultStore.create(Options.StorePath, Entries))
+            return false;
+    }
+    if (Options.ShardCount != 0)
+        std::cout << "shard " << ShardVersion << " " << Options.ShardIndex << " " << Options.ShardCount << " " << getRunSignature() << "\n";
+    if (!Options.CheckpointPath.empty()) {
+        Checkpoint.open(Options.CheckpointPath, Options.CheckpointInterval);
+        if (Options.Resume && !Checkpoint.load())
+            return false;
+    }
+    if (Options.FindFirst)
+        return runFindFirst(Pool, Operations);
+#ifdef VERIFY_WITH_Z3
+    if (Options.SelectedBackend == Backend::SMT) {
+        runSymbolicTests(Pool, Operations);
+        return true;
+    }
+#endif
+    if (Options.SelectedSchedule == Schedule::Grid)
+        return runGrid(Pool, Operations);
+    unsigned NumConfigs = 0, NumEnumerated = 0, NumStatic = 0;
+    bool AnyUnary = false;
+    for (const TransferFunctionInfo *Op : Operations)
+        AnyUnary |= Op->Arity == 1;
+    for (unsigned BitWidth = Options.MinBitWidth; BitWidth <= Options.MaxBitWidth; ++BitWidth) {
+        // The domain is only tabulated for the optimal tables of unary operations
+        AbstractDomainTable Domain;
+        bool Tabulate = (Options.Optimal || Options.Soundness) && AnyUnary && BitWidth <= MaxOptimalTableBitWidth;
+        if (Tabulate)
+            buildAbstractDomainTable(Pool, BitWidth, Domain);
+        for (const TransferFunctionInfo *Op : Operations) {
+            for (unsigned Param : getSweptParams(Op->Param, BitWidth)) {
+                if (Options.SampleBudget != 0) {
+                    testSampled(Pool, *Op, BitWidth, Param);
+                    continue;
+                }
+                // Every input of the configuration is known to compare equal
+                if (Options.SkipStatic && BitWidth <= Op->StaticBitWidth) {
+                    PrecisionCounts Counts;
+                    Counts.record(PrecisionOrder::Equal, numAbstractValues(BitWidth));
+                    printPrecisionCounts(*Op, BitWidth, Param, Counts, 0, -1);
+                    ++NumStatic;
+                    ++NumConfigs;
+                    continue;
+                }
+                NumEnumerated += testTransferFunctions(Pool, *Op, BitWidth, Param, Tabulate ? &Domain : nullptr);
+                ++NumConfigs;
+            }
+        }
+    }
+    if (Checkpoint.enabled())
+        Checkpoint.save();
+    if ((Options.Generalize || Options.GroupByMask) && Options.Format == OutputFormat::Text)
+        std::cout << "Configurations Enumerated In Full: " << NumEnumerated << " of " << NumConfigs << "\n";
+    if (Cache.enabled() && Options.Format == OutputFormat::Text)
+        std::cout << "Configurations Reused From Cache: " << Cache.getNumReused() << " of " << NumConfigs << "\n";
+    if (Options.SkipStatic && Options.Format == OutputFormat::Text)
+        std::cout << "Configurations Verified At Compile Time: " << NumStatic << " of " << NumConfigs << "\n";
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!parseOptions(argc, argv)) {
+        printUsage(errs(), argv[0]);
+        return 1;
+    }
+    if (Options.ListOperations) {
+        listTransferFunctions(outs());
+        return 0;
+    }
+
+    std::vector<const TransferFunctionInfo *> Operations;
+    if (!selectTransferFunctions(Operations))
+        return 1;
+    for (const TransferFunctionInfo *Op : Operations) {
+#ifdef VERIFY_WITH_Z3
+        if (Options.SelectedBackend == Backend::SMT) {
+            if (!findSymbolicTransferFunction(Op->Name)) {
+                errs() << "error: " << Op->Name << " has no symbolic encoding for the smt backend\n";
+                return 1;
+            }
+            continue;
+        }
+#endif
+        if (Options.Stratified && Options.SampleBudget < Op->Arity * Options.MaxBitWidth + 1) {
+            errs() << "error: --stratified needs at least one sample per number of unknown bits, "
+                   << Op->Arity * Options.MaxBitWidth + 1 << " for " << Op->Name << "\n";
+            return 1;
+        }
+        if (Options.FindFirst && Op->Arity * Options.MaxBitWidth > MaxExhaustiveBitWidth) {
+            errs() << "error: --find-first supports " << Op->Name << " at bitwidths up to "
+                   << MaxExhaustiveBitWidth / Op->Arity << "\n";
+            return 1;
+        }
+        if (Op->Arity == 2 && Options.SelectedBackend == Backend::GPU) {
+            errs() << "error: the gpu backend sweeps unary operations, not " << Op->Name << "\n";
+            return 1;
+        }
+        if (Op->Arity == 2 && Options.SelectedBackend != Backend::APInt &&
+            Options.MaxBitWidth > MaxBinaryFixedBitWidth) {
+            errs() << "error: fixed-width sweeps of binary operations support bitwidths up to "
+                   << MaxBinaryFixedBitWidth << "\n";
+            return 1;
+        }
+        unsigned MaxOptimal = Op->Arity == 2 ? MaxOptimalBinaryBitWidth : MaxOptimalBitWidth;
+        if ((Options.Optimal || Options.Soundness) && Options.MaxBitWidth > MaxOptimal) {
+            errs() << "error: " << (Options.Optimal ? "--optimal" : "--soundness") << " supports " << Op->Name
+                   << " at bitwidths up to " << MaxOptimal << "\n";
+            return 1;
+        }
+    }
+    bool Passed = runTests(Operations);
+#ifdef VERIFY_STATS
+    printStats(errs());
+#endif
+    return Passed ? 0 : 1;
 }
@@ -0,0 +1,255 @@
+// GPU backend of the exhaustive sweeps (--backend gpu). Each thread takes base-3
+// indices of abstract values, decodes their Zero/One masks, runs the composite
+// and decomposed functions of a unary operation and counts the precision order
+// of the results. Counters are reduced within each warp with shuffles and added
+// to global memory once per warp.
+//
+// The decoding, the transfer functions and the comparison are those of the
+// fixed-width backend, compiled for the device from known_bits_fixed.h. Kernels
+// are instantiated per operation and bitwidth, like FixedSweeps in main.cpp.
+// With --differential the order of every input is also returned, and main.cpp
+// compares it with the fixed backend's.
+//
+// Built separately with nvcc and linked into a build of main.cpp with
+// -DVERIFY_WITH_CUDA, see the README. Nothing here depends on LLVM.
+
+#include "known_bits_fixed.h"
+#include <cuda_runtime.h>
+#include <algorithm>
+#include <array>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+namespace {
+
+// Unary operations with device kernels, forwarding to their fixed-width functions
+struct SextInRegKernels {
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> composite(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return sextInRegCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> decomposed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return sextInRegDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct ZextInRegKernels {
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> composite(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return zextInRegCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> decomposed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return zextInRegDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct ShlKernels {
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> composite(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return shlCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> decomposed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return shlDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct LshrKernels {
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> composite(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return lshrCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> decomposed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return lshrDecomposedFixed(KBInstance, Param);
+    }
+};
+
+struct AshrKernels {
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> composite(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return ashrCompositeFixed(KBInstance, Param);
+    }
+    template <unsigned N>
+    __device__ static KnownBitsFixed<N> decomposed(const KnownBitsFixed<N> &KBInstance, unsigned Param) {
+        return ashrDecomposedFixed(KBInstance, Param);
+    }
+};
+
+// Counters in PrecisionOrder order
+const unsigned NumOrders = 4;
+
+// Largest bitwidth with kernels. Wider domains cannot be indexed by a uint64_t,
+// see MaxExhaustiveBitWidth in main.cpp.
+const unsigned MaxDeviceBitWidth = 40;
+
+// The device copy of TritBlocks, see uploadTritBlocks
+__constant__ uint64_t DeviceBlockZero[TritBlockSize];
+__constant__ uint64_t DeviceBlockOne[TritBlockSize];
+
+// Largest number of indices swept by one kernel launch, so that a launch stays
+// well below the watchdog limit of GPUs that also drive a display. Launches that
+// return orders are shorter, so that their orders fit a 64MB buffer.
+const uint64_t MaxLaunchItems = uint64_t(1) << 32;
+const uint64_t MaxOrderLaunchItems = uint64_t(1) << 28;
+
+const unsigned ThreadsPerBlock = 256;
+
+// Function to sum a counter over the lanes of the calling warp into lane 0
+__device__ inline unsigned long long warpSum(unsigned long long Value) {
+    for (unsigned Offset = warpSize / 2; Offset > 0; Offset /= 2)
+        Value += __shfl_down_sync(0xffffffffu, Value, Offset);
+    return Value;
+}
+
+// Kernel sweeping the indices [Begin, Begin + NumItems) of a configuration of Op
+// at bitwidth N, adding the number of inputs of each order to Counts. If Orders
+// is not null, the order of input Begin + i is also stored in bits 2 * (i % 16)
+// of Orders[i / 16]. Both host and device are little-endian, so these are the
+// bytes of storePrecisionOrder in main.cpp.
+template <typename Op, unsigned N>
+__global__ void sweepKernel(unsigned Param, uint64_t Begin, uint64_t NumItems, unsigned long long *Counts,
+                            unsigned *Orders) {
+    unsigned long long Local[NumOrders] = {0, 0, 0, 0};
+    uint64_t Stride = uint64_t(gridDim.x) * blockDim.x;
+    for (uint64_t Item = uint64_t(blockIdx.x) * blockDim.x + threadIdx.x; Item < NumItems; Item += Stride) {
+        KnownBitsFixed<N> KBInstance;
+        decodeKnownBitsMasks(DeviceBlockZero, DeviceBlockOne, Begin + Item, N, KBInstance.Zero, KBInstance.One);
+        unsigned Order = unsigned(comparePrecisionFixed(Op::composite(KBInstance, Param),
+                                                        Op::decomposed(KBInstance, Param)));
+        for (unsigned i = 0; i < NumOrders; ++i)
+            Local[i] += Order == i;
+        if (Orders)
+            atomicOr(&Orders[Item / 16], Order << (2 * (Item % 16)));
+    }
+
+    // Every lane of the block's warps reaches the shuffles, also lanes without items
+    for (unsigned i = 0; i < NumOrders; ++i) {
+        unsigned long long Sum = warpSum(Local[i]);
+        if (threadIdx.x % warpSize == 0 && Sum != 0)
+            atomicAdd(&Counts[i], Sum);
+    }
+}
+
+typedef void (*LaunchFn)(unsigned Blocks, unsigned Param, uint64_t Begin, uint64_t NumItems,
+                         unsigned long long *Counts, unsigned *Orders);
+typedef std::array<LaunchFn, MaxDeviceBitWidth> LaunchTable;
+
+template <typename Op, unsigned N>
+void launch(unsigned Blocks, unsigned Param, uint64_t Begin, uint64_t NumItems, unsigned long long *Counts,
+            unsigned *Orders) {
+    sweepKernel<Op, N><<<Blocks, ThreadsPerBlock>>>(Param, Begin, NumItems, Counts, Orders);
+}
+
+template <typename Op, size_t... Widths>
+LaunchTable makeLaunchTable(std::index_sequence<Widths...>) {
+    return {{&launch<Op, Widths + 1>...}};
+}
+
+// Function to write a CUDA failure into Error, returning whether Status is success
+bool checkCuda(cudaError_t Status, const char *What, char *Error, size_t ErrorSize) {
+    if (Status == cudaSuccess)
+        return true;
+    snprintf(Error, ErrorSize, "%s: %s", What, cudaGetErrorString(Status));
+    return false;
+}
+
+// Function to copy TritBlocks to the constant memory of the current device. The
+// copy is made on every sweep: it is 4KB, and the caller may have switched
+// devices or reset the context since the last one.
+bool uploadTritBlocks(char *Error, size_t ErrorSize) {
+    return checkCuda(cudaMemcpyToSymbol(DeviceBlockZero, TritBlocks.Zero, sizeof(TritBlocks.Zero)),
+                     "cudaMemcpyToSymbol", Error, ErrorSize) &&
+           checkCuda(cudaMemcpyToSymbol(DeviceBlockOne, TritBlocks.One, sizeof(TritBlocks.One)),
+                     "cudaMemcpyToSymbol", Error, ErrorSize);
+}
+
+} // namespace
+
+// Function to sweep the abstract values with indices in [Begin, End) of the unary
+// operation Name at BitWidth <= 40 with parameter Param on the current CUDA device.
+// Adds the number of inputs of each precision order to Counts, in PrecisionOrder
+// order. If Orders is not null, Begin must be a multiple of four, and the orders
+// of the inputs are packed into Orders[0, (End - Begin + 3) / 4) like
+// storePrecisionOrder packs them. Returns 0 on success, or -1 with a message in
+// Error if Name has no device implementation or CUDA fails.
+extern "C" int sweepUnaryOnGPU(const char *Name, unsigned BitWidth, unsigned Param, uint64_t Begin, uint64_t End,
+                               uint64_t Counts[4], uint8_t *Orders, char *Error, size_t ErrorSize) {
+    static const struct {
+        const char *Name;
+        LaunchTable Launches;
+    } Ops[] = {{"sextInReg", makeLaunchTable<SextInRegKernels>(std::make_index_sequence<MaxDeviceBitWidth>())},
+               {"zextInReg", makeLaunchTable<ZextInRegKernels>(std::make_index_sequence<MaxDeviceBitWidth>())},
+               {"shl", makeLaunchTable<ShlKernels>(std::make_index_sequence<MaxDeviceBitWidth>())},
+               {"lshr", makeLaunchTable<LshrKernels>(std::make_index_sequence<MaxDeviceBitWidth>())},
+               {"ashr", makeLaunchTable<AshrKernels>(std::make_index_sequence<MaxDeviceBitWidth>())}};
+    const LaunchTable *Launches = nullptr;
+    for (const auto &Entry : Ops) {
+        if (strcmp(Entry.Name, Name) == 0)
+            Launches = &Entry.Launches;
+    }
+    if (!Launches) {
+        snprintf(Error, ErrorSize, "%s has no GPU implementation", Name);
+        return -1;
+    }
+    if (BitWidth == 0 || BitWidth > MaxDeviceBitWidth) {
+        snprintf(Error, ErrorSize, "the gpu backend supports bitwidths up to %u", MaxDeviceBitWidth);
+        return -1;
+    }
+    if (!uploadTritBlocks(Error, ErrorSize))
+        return -1;
+
+    int Device, NumSMs;
+    if (!checkCuda(cudaGetDevice(&Device), "cudaGetDevice", Error, ErrorSize) ||
+        !checkCuda(cudaDeviceGetAttribute(&NumSMs, cudaDevAttrMultiProcessorCount, Device),
+                   "cudaDeviceGetAttribute", Error, ErrorSize))
+        return -1;
+
+    // Launches that return orders start at multiples of 16 items after Begin, at
+    // a whole word of the device buffer and a whole byte of Orders
+    uint64_t LaunchItems = Orders ? MaxOrderLaunchItems : MaxLaunchItems;
+    uint64_t OrderWords = Orders ? (std::min(End - Begin, LaunchItems) + 15) / 16 : 0;
+    unsigned long long *DeviceCounts = nullptr;
+    unsigned *DeviceOrders = nullptr;
+    bool Ok = checkCuda(cudaMalloc(&DeviceCounts, NumOrders * sizeof(unsigned long long)), "cudaMalloc", Error,
+                        ErrorSize) &&
+              checkCuda(cudaMemset(DeviceCounts, 0, NumOrders * sizeof(unsigned long long)), "cudaMemset", Error,
+                        ErrorSize) &&
+              (!Orders || checkCuda(cudaMalloc(&DeviceOrders, OrderWords * sizeof(unsigned)), "cudaMalloc", Error,
+                                    ErrorSize));
+
+    // Enough blocks to fill every multiprocessor several times over; each thread
+    // strides through its share of the launch
+    for (uint64_t First = Begin; Ok && First < End; First += LaunchItems) {
+        uint64_t NumItems = std::min(End - First, LaunchItems);
+        uint64_t Needed = (NumItems + ThreadsPerBlock - 1) / ThreadsPerBlock;
+        unsigned Blocks = unsigned(std::min(Needed, uint64_t(NumSMs) * 32));
+        if (Orders)
+            Ok = checkCuda(cudaMemset(DeviceOrders, 0, OrderWords * sizeof(unsigned)), "cudaMemset", Error,
+                           ErrorSize);
+        if (!Ok)
+            break;
+        (*Launches)[BitWidth - 1](Blocks, Param, First, NumItems, DeviceCounts, DeviceOrders);
+        Ok = checkCuda(cudaGetLastError(), "kernel launch", Error, ErrorSize) &&
+             checkCuda(cudaDeviceSynchronize(), "kernel", Error, ErrorSize);
+        if (Ok && Orders)
+            Ok = checkCuda(cudaMemcpy(Orders + (First - Begin) / 4, DeviceOrders, (NumItems + 3) / 4,
+                                      cudaMemcpyDeviceToHost),
+                           "cudaMemcpy", Error, ErrorSize);
+    }
+
+    unsigned long long HostCounts[NumOrders];
+    Ok = Ok && checkCuda(cudaMemcpy(HostCounts, DeviceCounts, sizeof(HostCounts), cudaMemcpyDeviceToHost),
+                         "cudaMemcpy", Error, ErrorSize);
+    cudaFree(DeviceCounts);
+    cudaFree(DeviceOrders);
+    if (!Ok)
+        return -1;
+    for (unsigned i = 0; i < NumOrders; ++i)
+        Counts[i] += HostCounts[i];
+    return 0;
+}